@@ -0,0 +1,76 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////// Work group //
+layout (local_size_x = 64) in;
+
+// ////////////////////////////////////////////////////////// Structures //
+// Matches CullingInstance on the CPU side
+struct Instance {
+    mat4 world;
+    // Model-space bounding sphere: center and radius, negative if empty
+    vec4 sphere;
+    uvec4 command;
+};
+
+// Matches the layout glMultiDrawElementsIndirect reads
+struct Command {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+// ///////////////////////////////////////////////////////////// Buffers //
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+layout (std430, binding = 1) buffer Commands {
+    Command commands[];
+};
+
+layout (std430, binding = 2) writeonly buffer VisibleWorlds {
+    mat4 visibleWorlds[];
+};
+
+// //////////////////////////////////////////////////////////// Uniforms //
+// Normals pointing inwards, as in Frustum on the CPU side
+uniform vec4 frustumPlanes[6];
+uniform uint instanceCount;
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= instanceCount) {
+        return;
+    }
+
+    mat4 world = instances[index].world;
+    vec4 sphere = instances[index].sphere;
+    if (sphere.w < 0.0) {
+        return;
+    }
+
+    // World-space sphere; the largest axis scale keeps it conservative
+    vec3 center = (world * vec4(sphere.xyz, 1.0)).xyz;
+    float scale = sqrt(max(dot(world[0].xyz, world[0].xyz),
+                           max(dot(world[1].xyz, world[1].xyz),
+                               dot(world[2].xyz, world[2].xyz))));
+    float radius = sphere.w * scale;
+
+    for (int i = 0; i < 6; ++i) {
+        if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w
+                < -radius) {
+            return;
+        }
+    }
+
+    // Append to the command's range; the order within it does not matter
+    uint command = instances[index].command.x;
+    uint slot = atomicAdd(commands[command].instanceCount, 1u);
+    visibleWorlds[commands[command].baseInstance + slot] = world;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,71 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////////// Inputs //
+in vec2 positionF;
+flat in vec3 centerF;
+flat in mat4 transformF;
+flat in mat4 inverseTransformF;
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out vec4 outColor;
+
+// //////////////////////////////////////////////////////////// Uniforms //
+uniform sampler2D texture0;
+
+// /////////////////////////////////////////////////////////// Constants //
+const float PI = 3.1415926535897932384626433832795;
+const float RADIUS = 1.0;
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    // The pixel's ray between the near and far planes, in the sphere's
+    // own space
+    vec4 nearPoint = inverseTransformF * vec4(positionF, -1.0, 1.0);
+    vec4 farPoint = inverseTransformF * vec4(positionF, 1.0, 1.0);
+    vec3 origin = nearPoint.xyz / nearPoint.w;
+    vec3 direction = farPoint.xyz / farPoint.w - origin;
+
+    // |origin + t * direction - center| = RADIUS
+    vec3 offset = origin - centerF;
+    float a = dot(direction, direction);
+    float b = dot(offset, direction);
+    float c = dot(offset, offset) - RADIUS * RADIUS;
+    float discriminant = b * b - a * c;
+
+    // Nearest hit in front of the near plane; from inside the sphere,
+    // that is the far side. Misses are only discarded at the end, since
+    // texture derivatives need every pixel of the quad.
+    float root = sqrt(max(discriminant, 0.0));
+    float t = (-b - root) / a;
+    if (t < 0.0) {
+        t = (-b + root) / a;
+    }
+    bool missed = discriminant < 0.0 || t < 0.0 || t > 1.0;
+
+    vec3 hit = origin + t * direction;
+    vec4 clipPosition = transformF * vec4(hit, 1.0);
+    gl_FragDepth = 0.5 * (gl_DepthRange.diff
+                          * (clipPosition.z / clipPosition.w)
+                          + gl_DepthRange.near + gl_DepthRange.far);
+
+    // Same mapping as the sphere meshes: latitude from the north pole
+    // along s, longitude along t. Longitude wraps around at the seam, so
+    // of two equivalent parametrizations the one continuous across this
+    // pixel's neighbours is used, or the seam gets the smallest mipmap.
+    vec3 normal = (hit - centerF) / RADIUS;
+    float latitude = acos(clamp(normal.z, -1.0, 1.0)) / PI;
+    float longitude = atan(normal.y, normal.x) / (2.0 * PI);
+
+    float wrapped = fract(longitude);
+    float centered = fract(longitude + 0.5) - 0.5;
+    outColor = texture(texture0,
+                       vec2(latitude, fwidth(wrapped) <= fwidth(centered)
+                                      ? wrapped : centered));
+
+    if (missed) {
+        discard;
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
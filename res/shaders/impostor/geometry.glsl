@@ -0,0 +1,70 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////// Primitives //
+layout (points) in;
+layout (triangle_strip, max_vertices = 4) out;
+
+// ////////////////////////////////////////////////////////////// Inputs //
+in mat4 transformG[];
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out vec2 positionF;
+flat out vec3 centerF;
+flat out mat4 transformF;
+flat out mat4 inverseTransformF;
+
+// /////////////////////////////////////////////////////////// Constants //
+const float RADIUS = 1.0;
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    vec3 center = gl_in[0].gl_Position.xyz;
+    mat4 transform = transformG[0];
+
+    // Screen rectangle around the projected corners of the sphere's box;
+    // a box reaching behind the camera may cover any part of the screen
+    vec2 lower = vec2(1.0);
+    vec2 upper = vec2(-1.0);
+    bool behindCamera = false;
+
+    for (int corner = 0; corner < 8; ++corner) {
+        vec3 side = vec3(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+        vec4 position = transform
+            * vec4(center + RADIUS * (2.0 * side - 1.0), 1.0);
+
+        if (position.w <= 0.0) {
+            behindCamera = true;
+            break;
+        }
+        lower = min(lower, position.xy / position.w);
+        upper = max(upper, position.xy / position.w);
+    }
+
+    if (behindCamera) {
+        lower = vec2(-1.0);
+        upper = vec2(1.0);
+    }
+    lower = max(lower, vec2(-1.0));
+    upper = min(upper, vec2(1.0));
+    if (any(greaterThanEqual(lower, upper))) {
+        return;
+    }
+
+    // The fragment shader writes the real depth, so the quad itself
+    // only has to stay inside the clip volume
+    mat4 inverseTransform = inverse(transform);
+    for (int corner = 0; corner < 4; ++corner) {
+        positionF = vec2((corner & 1) == 0 ? lower.x : upper.x,
+                         (corner & 2) == 0 ? lower.y : upper.y);
+        centerF = center;
+        transformF = transform;
+        inverseTransformF = inverseTransform;
+
+        gl_Position = vec4(positionF, 0.0, 1.0);
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+
+// ///////////////////////////////////////////////////////////////////// //
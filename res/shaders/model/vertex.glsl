@@ -4,16 +4,17 @@
 // ////////////////////////////////////////////////////////////// Inputs //
 layout (location = 0) in vec3 posV;
 layout (location = 1) in vec2 texCoordV;
+layout (location = 2) in mat4 worldV;
 
 // ///////////////////////////////////////////////////////////// Outputs //
 out vec2 texCoordG;
 
 // //////////////////////////////////////////////////////////// Uniforms //
-uniform mat4 transform;
+uniform mat4 viewProjection;
 
 // //////////////////////////////////////////////////////////////// Main //
 void main() {
-    gl_Position = transform * vec4(posV, 1.0);
+    gl_Position = viewProjection * worldV * vec4(posV, 1.0);
     texCoordG = texCoordV;
 }
 
@@ -5,11 +5,13 @@
 layout (points) in;
 layout (triangle_strip, max_vertices = 160) out;
 
+// ////////////////////////////////////////////////////////////// Inputs //
+in mat4 transformG[];
+
 // ///////////////////////////////////////////////////////////// Outputs //
 out vec2 texCoordF;
 
 // /////////////////////////////////////////////////////////// Uniforms //
-uniform mat4 transform;
 uniform int subdivisionLevelHorizontal;
 uniform int subdivisionLevelVertical;
 
@@ -55,7 +57,7 @@ void main() {
             for (int j = 0; j <= h; j++) {
                 phi = (2.0 * PI) * (j / h);
 
-                sphere[i][j] = transform
+                sphere[i][j] = transformG[point]
                     * (origin + vec4(
                         sphericalToCartesian(vec3(r, theta, phi)),
                         0.0));// - vec4(0.0, r / 2.0, 0.0, 0.0));
@@ -3,10 +3,18 @@
 
 // ////////////////////////////////////////////////////////////// Inputs //
 layout (location = 0) in vec3 posV;
+layout (location = 2) in mat4 worldV;
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out mat4 transformG;
+
+// //////////////////////////////////////////////////////////// Uniforms //
+uniform mat4 viewProjection;
 
 // //////////////////////////////////////////////////////////////// Main //
 void main() {
     gl_Position = vec4(posV, 1.0);
+    transformG = viewProjection * worldV;
 }
 
 // ///////////////////////////////////////////////////////////////////// //
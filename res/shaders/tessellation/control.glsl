@@ -0,0 +1,72 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////// Primitives //
+layout (vertices = 4) out;
+
+// ////////////////////////////////////////////////////////////// Inputs //
+in vec3 positionC[];
+in vec2 texCoordC[];
+in mat4 worldC[];
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out vec2 texCoordE[];
+patch out mat4 transformE;
+
+// //////////////////////////////////////////////////////////// Uniforms //
+uniform mat4 viewProjection;
+uniform float viewportHeight;
+
+// /////////////////////////////////////////////////////////// Constants //
+const float PIXELS_PER_SEGMENT = 16.0;
+const float LEVEL_MAX = 64.0;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+// Segments for the edge from a to b: the on-screen diameter of the
+// sphere around the edge, which does not depend on the edge's direction.
+// Neighbouring patches see the same two points, so shared edges always
+// agree and the surface stays watertight.
+float edgeLevel(vec3 a, vec3 b, float projectionScale) {
+    float diameter = distance(a, b);
+    float depth = (viewProjection * vec4(0.5 * (a + b), 1.0)).w;
+
+    if (depth <= 0.5 * diameter) {
+        return LEVEL_MAX;
+    }
+    float pixels = 0.5 * viewportHeight * projectionScale
+                 * diameter / depth;
+    return clamp(pixels / PIXELS_PER_SEGMENT, 1.0, LEVEL_MAX);
+}
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    texCoordE[gl_InvocationID] = texCoordC[gl_InvocationID];
+
+    if (gl_InvocationID == 0) {
+        transformE = viewProjection * worldC[0];
+
+        // For a rigid view, the length of the second row's rotation part
+        // is the vertical projection scale
+        float projectionScale = length(vec3(viewProjection[0][1],
+                                            viewProjection[1][1],
+                                            viewProjection[2][1]));
+
+        // Corners are (0, 0), (1, 0), (0, 1), (1, 1) in (u, v); outer
+        // levels go u = 0, v = 0, u = 1, v = 1
+        gl_TessLevelOuter[0] = edgeLevel(positionC[0], positionC[2],
+                                         projectionScale);
+        gl_TessLevelOuter[1] = edgeLevel(positionC[0], positionC[1],
+                                         projectionScale);
+        gl_TessLevelOuter[2] = edgeLevel(positionC[1], positionC[3],
+                                         projectionScale);
+        gl_TessLevelOuter[3] = edgeLevel(positionC[2], positionC[3],
+                                         projectionScale);
+
+        gl_TessLevelInner[0] = max(gl_TessLevelOuter[1],
+                                   gl_TessLevelOuter[3]);
+        gl_TessLevelInner[1] = max(gl_TessLevelOuter[0],
+                                   gl_TessLevelOuter[2]);
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,38 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////// Primitives //
+layout (quads, fractional_odd_spacing, cw) in;
+
+// ////////////////////////////////////////////////////////////// Inputs //
+in vec2 texCoordE[];
+patch in mat4 transformE;
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out vec2 texCoordF;
+
+// /////////////////////////////////////////////////////////// Constants //
+const float PI = 3.1415926535897932384626433832795;
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    // Texture coordinates are the sphere's parameters, so interpolating
+    // them and not the positions keeps every vertex on the sphere. The
+    // seam column ends at 1, which wraps to the first column's longitude.
+    precise vec2 texCoord = mix(mix(texCoordE[0], texCoordE[1],
+                                    gl_TessCoord.x),
+                                mix(texCoordE[2], texCoordE[3],
+                                    gl_TessCoord.x),
+                                gl_TessCoord.y);
+
+    float theta = (PI / 2.0) - (PI * texCoord.s);
+    float phi = (2.0 * PI) * fract(texCoord.t);
+
+    gl_Position = transformE * vec4(cos(theta) * cos(phi),
+                                    cos(theta) * sin(phi),
+                                    sin(theta),
+                                    1.0);
+    texCoordF = texCoord;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
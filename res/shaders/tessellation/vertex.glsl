@@ -0,0 +1,21 @@
+// //////////////////////////////////////////////////////// GLSL version //
+#version 430 core
+
+// ////////////////////////////////////////////////////////////// Inputs //
+layout (location = 0) in vec3 posV;
+layout (location = 1) in vec2 texCoordV;
+layout (location = 2) in mat4 worldV;
+
+// ///////////////////////////////////////////////////////////// Outputs //
+out vec3 positionC;
+out vec2 texCoordC;
+out mat4 worldC;
+
+// //////////////////////////////////////////////////////////////// Main //
+void main() {
+    positionC = vec3(worldV * vec4(posV, 1.0));
+    texCoordC = texCoordV;
+    worldC = worldV;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,467 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "aabb-tree.hpp"
+
+#include <algorithm>
+#include <exception>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::vec3;
+
+using std::exception;
+using std::vector;
+
+// ///////////////////////////////////////////////////// Class: AabbTree //
+AabbTree::Proxy const AabbTree::NONE;
+std::uint32_t const AabbTree::INSIDE_FLAG;
+std::size_t const AabbTree::SAH_BIN_COUNT;
+
+AabbTree::AabbTree(float const margin)
+        : root(NONE),
+          firstFree(NONE),
+          leafCount(0),
+          margin(margin),
+          cost(0.0f),
+          costAfterRebuild(0.0f) {
+}
+
+AabbTree::Proxy AabbTree::insert(BoundingBox const &box,
+                                 std::uint32_t const userData) {
+    if (box.isEmpty()) {
+        throw exception("Cannot insert an empty box into the tree!");
+    }
+
+    refit();
+
+    Proxy const leaf = allocateNode();
+    vec3 const enlargement = margin * (box.max - box.min);
+
+    nodes[leaf].box = BoundingBox(box.min - enlargement,
+                                  box.max + enlargement);
+    nodes[leaf].userData = userData;
+
+    insertLeaf(leaf);
+    ++leafCount;
+    return leaf;
+}
+
+void AabbTree::remove(Proxy const proxy) {
+    refit();
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --leafCount;
+}
+
+bool AabbTree::update(Proxy const proxy, BoundingBox const &box) {
+    BoundingBox const &fat = nodes[proxy].box;
+    if (box.isEmpty() ||
+        (glm::all(glm::lessThanEqual(fat.min, box.min)) &&
+         glm::all(glm::lessThanEqual(box.max, fat.max)))) {
+        return false;
+    }
+
+    // Refit instead of reinserting: the leaf stays where it is and only
+    // the boxes above it grow or shrink. Ancestors are queued once - the
+    // walk stops at the first one already waiting.
+    vec3 const enlargement = margin * (box.max - box.min);
+    nodes[proxy].box = BoundingBox(box.min - enlargement,
+                                   box.max + enlargement);
+
+    for (Proxy index = nodes[proxy].parent;
+         index != NONE && !nodes[index].refitPending;
+         index = nodes[index].parent) {
+        nodes[index].refitPending = true;
+        refitQueue.push_back(index);
+    }
+    return true;
+}
+
+void AabbTree::refit() {
+    if (refitQueue.empty()) {
+        return;
+    }
+
+    // Counting sort by height: children are always lower than their
+    // parents, so every box is recomputed after the boxes below it
+    int maxHeight = 0;
+    for (Proxy const index : refitQueue) {
+        maxHeight = std::max(maxHeight, nodes[index].height);
+    }
+
+    heightOffsets.assign(maxHeight + 2, 0);
+    for (Proxy const index : refitQueue) {
+        ++heightOffsets[nodes[index].height + 1];
+    }
+    for (std::size_t height = 1; height < heightOffsets.size(); ++height) {
+        heightOffsets[height] += heightOffsets[height - 1];
+    }
+
+    refitOrder.resize(refitQueue.size());
+    for (Proxy const index : refitQueue) {
+        refitOrder[heightOffsets[nodes[index].height]++] = index;
+    }
+    refitQueue.clear();
+
+    for (Proxy const index : refitOrder) {
+        Node const &node = nodes[index];
+        setBox(index, merged(nodes[node.children[0]].box,
+                             nodes[node.children[1]].box));
+        nodes[index].refitPending = false;
+    }
+}
+
+void AabbTree::rebuild() {
+    refit();
+
+    vector<Proxy> leaves;
+    leaves.reserve(leafCount);
+    centers.resize(nodes.size());
+
+    for (Proxy index = 0; index < nodes.size(); ++index) {
+        if (nodes[index].height == 0) {
+            leaves.push_back(index);
+            centers[index] = nodes[index].box.getCenter();
+        } else if (nodes[index].height > 0) {
+            freeNode(index);
+        }
+    }
+
+    root = leaves.empty() ? NONE : build(leaves.data(), leaves.size());
+    if (root != NONE) {
+        nodes[root].parent = NONE;
+    }
+    costAfterRebuild = cost;
+}
+
+void AabbTree::clear() {
+    nodes.clear();
+    refitQueue.clear();
+    root = NONE;
+    firstFree = NONE;
+    leafCount = 0;
+    cost = 0.0f;
+    costAfterRebuild = 0.0f;
+}
+
+std::uint32_t AabbTree::getUserData(Proxy const proxy) const {
+    return nodes[proxy].userData;
+}
+
+BoundingBox const &AabbTree::getFatBounds(Proxy const proxy) const {
+    return nodes[proxy].box;
+}
+
+std::size_t AabbTree::size() const {
+    return leafCount;
+}
+
+int AabbTree::getHeight() const {
+    return root == NONE ? 0 : nodes[root].height;
+}
+
+float AabbTree::getCost() const {
+    return cost;
+}
+
+float AabbTree::getCostAfterRebuild() const {
+    return costAfterRebuild;
+}
+
+float AabbTree::surfaceArea(BoundingBox const &box) {
+    if (box.isEmpty()) {
+        return 0.0f;
+    }
+    vec3 const size = box.max - box.min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+BoundingBox AabbTree::merged(BoundingBox const &a, BoundingBox const &b) {
+    BoundingBox box = a;
+    box.extend(b);
+    return box;
+}
+
+AabbTree::Proxy AabbTree::allocateNode() {
+    Proxy index = firstFree;
+    if (index == NONE) {
+        index = static_cast<Proxy>(nodes.size());
+        nodes.emplace_back();
+    } else {
+        firstFree = nodes[index].parent;
+    }
+
+    Node &node = nodes[index];
+    node.box = BoundingBox();
+    node.parent = NONE;
+    node.children[0] = NONE;
+    node.children[1] = NONE;
+    node.userData = NONE;
+    node.height = 0;
+    node.refitPending = false;
+    return index;
+}
+
+void AabbTree::freeNode(Proxy const index) {
+    Node &node = nodes[index];
+    if (!node.isLeaf()) {
+        cost -= surfaceArea(node.box);
+    }
+
+    node.parent = firstFree;
+    node.children[0] = NONE;
+    node.height = -1;
+    firstFree = index;
+}
+
+void AabbTree::setBox(Proxy const index, BoundingBox const &box) {
+    Node &node = nodes[index];
+    if (!node.isLeaf()) {
+        cost += surfaceArea(box) - surfaceArea(node.box);
+    }
+    node.box = box;
+}
+
+void AabbTree::insertLeaf(Proxy const leaf) {
+    if (root == NONE) {
+        root = leaf;
+        nodes[root].parent = NONE;
+        return;
+    }
+
+    // Walk down towards the cheapest sibling: a new parent costs the area
+    // of the merged box, every level above it grows by the enlargement
+    BoundingBox const box = nodes[leaf].box;
+    Proxy index = root;
+    while (!nodes[index].isLeaf()) {
+        Node const &node = nodes[index];
+
+        float const area = surfaceArea(node.box);
+        float const combinedArea = surfaceArea(merged(node.box, box));
+
+        float const siblingCost = 2.0f * combinedArea;
+        float const inheritedCost = 2.0f * (combinedArea - area);
+
+        float descendCosts[2];
+        for (int i = 0; i < 2; ++i) {
+            Node const &child = nodes[node.children[i]];
+            float const enlarged = surfaceArea(merged(child.box, box));
+            descendCosts[i] = inheritedCost +
+                    (child.isLeaf() ? enlarged
+                                    : enlarged - surfaceArea(child.box));
+        }
+
+        if (siblingCost < descendCosts[0] && siblingCost < descendCosts[1]) {
+            break;
+        }
+        index = node.children[descendCosts[0] < descendCosts[1] ? 0 : 1];
+    }
+
+    Proxy const sibling = index;
+    Proxy const oldParent = nodes[sibling].parent;
+    Proxy const newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].children[0] = sibling;
+    nodes[newParent].children[1] = leaf;
+    nodes[newParent].height = nodes[sibling].height + 1;
+    setBox(newParent, merged(box, nodes[sibling].box));
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NONE) {
+        root = newParent;
+    } else {
+        Node &parent = nodes[oldParent];
+        parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+    }
+
+    refitAncestors(newParent);
+}
+
+void AabbTree::removeLeaf(Proxy const leaf) {
+    if (leaf == root) {
+        root = NONE;
+        return;
+    }
+
+    Proxy const parent = nodes[leaf].parent;
+    Proxy const grandParent = nodes[parent].parent;
+    Proxy const sibling = nodes[parent].children[
+            nodes[parent].children[0] == leaf ? 1 : 0];
+
+    // The sibling takes the parent's place
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    if (grandParent == NONE) {
+        root = sibling;
+    } else {
+        Node &node = nodes[grandParent];
+        node.children[node.children[0] == parent ? 0 : 1] = sibling;
+        refitAncestors(grandParent);
+    }
+}
+
+void AabbTree::refitAncestors(Proxy index) {
+    while (index != NONE) {
+        index = balance(index);
+
+        Node const &node = nodes[index];
+        Node const &first = nodes[node.children[0]];
+        Node const &second = nodes[node.children[1]];
+
+        nodes[index].height = 1 + std::max(first.height, second.height);
+        setBox(index, merged(first.box, second.box));
+        index = nodes[index].parent;
+    }
+}
+
+AabbTree::Proxy AabbTree::balance(Proxy const a) {
+    // AVL-style rotation: when one child is more than a level taller, its
+    // taller grandchild is moved up to replace it
+    if (nodes[a].isLeaf() || nodes[a].height < 2) {
+        return a;
+    }
+
+    for (int side = 0; side < 2; ++side) {
+        Proxy const shorter = nodes[a].children[side];
+        Proxy const taller = nodes[a].children[1 - side];
+
+        if (nodes[taller].height - nodes[shorter].height <= 1) {
+            continue;
+        }
+
+        Proxy const first = nodes[taller].children[0];
+        Proxy const second = nodes[taller].children[1];
+        bool const firstIsTaller = nodes[first].height > nodes[second].height;
+        Proxy const kept = firstIsTaller ? first : second;
+        Proxy const moved = firstIsTaller ? second : first;
+
+        // taller takes a's place, a becomes its child
+        Proxy const parent = nodes[a].parent;
+        nodes[taller].parent = parent;
+        nodes[a].parent = taller;
+        if (parent == NONE) {
+            root = taller;
+        } else {
+            Node &node = nodes[parent];
+            node.children[node.children[0] == a ? 0 : 1] = taller;
+        }
+
+        nodes[taller].children[0] = a;
+        nodes[taller].children[1] = kept;
+        nodes[a].children[1 - side] = moved;
+        nodes[moved].parent = a;
+
+        nodes[a].height = 1 + std::max(nodes[shorter].height,
+                                       nodes[moved].height);
+        setBox(a, merged(nodes[shorter].box, nodes[moved].box));
+
+        nodes[taller].height = 1 + std::max(nodes[a].height,
+                                            nodes[kept].height);
+        setBox(taller, merged(nodes[a].box, nodes[kept].box));
+
+        return taller;
+    }
+    return a;
+}
+
+AabbTree::Proxy AabbTree::build(Proxy *const leaves,
+                                std::size_t const count) {
+    if (count == 1) {
+        return leaves[0];
+    }
+
+    BoundingBox centroids;
+    for (std::size_t i = 0; i < count; ++i) {
+        centroids.extend(centers[leaves[i]]);
+    }
+
+    vec3 const extent = centroids.max - centroids.min;
+    int const axis = (extent.x >= extent.y && extent.x >= extent.z)
+                     ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    std::size_t middle = count / 2;
+
+    if (extent[axis] > 0.0f) {
+        // Binned SAH: bucket the centroids along the widest axis and
+        // split where area times leaf count, summed over both sides, is
+        // lowest
+        struct Bin {
+            BoundingBox box;
+            std::size_t count;
+        } bins[SAH_BIN_COUNT];
+        for (auto &bin : bins) {
+            bin.count = 0;
+        }
+
+        float const scale = SAH_BIN_COUNT / extent[axis];
+        auto const binOf = [&](Proxy const leaf) {
+            float const centroid = centers[leaf][axis];
+            std::size_t const bin = static_cast<std::size_t>(
+                    (centroid - centroids.min[axis]) * scale);
+            return std::min(bin, SAH_BIN_COUNT - 1);
+        };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            Bin &bin = bins[binOf(leaves[i])];
+            bin.box.extend(nodes[leaves[i]].box);
+            ++bin.count;
+        }
+
+        float rightCosts[SAH_BIN_COUNT];
+        BoundingBox right;
+        std::size_t rightCount = 0;
+        for (std::size_t i = SAH_BIN_COUNT - 1; i > 0; --i) {
+            right.extend(bins[i].box);
+            rightCount += bins[i].count;
+            rightCosts[i] = surfaceArea(right) * rightCount;
+        }
+
+        BoundingBox left;
+        std::size_t leftCount = 0;
+        std::size_t bestSplit = 0;
+        float bestCost = std::numeric_limits<float>::max();
+        for (std::size_t i = 0; i + 1 < SAH_BIN_COUNT; ++i) {
+            left.extend(bins[i].box);
+            leftCount += bins[i].count;
+
+            float const splitCost = surfaceArea(left) * leftCount +
+                                    rightCosts[i + 1];
+            if (leftCount != 0 && leftCount != count &&
+                splitCost < bestCost) {
+                bestCost = splitCost;
+                bestSplit = i;
+            }
+        }
+
+        if (bestCost < std::numeric_limits<float>::max()) {
+            middle = std::partition(leaves, leaves + count,
+                                    [&](Proxy const leaf) {
+                                        return binOf(leaf) <= bestSplit;
+                                    }) - leaves;
+        } else {
+            std::nth_element(leaves, leaves + middle, leaves + count,
+                             [&](Proxy const a, Proxy const b) {
+                                 return centers[a][axis] < centers[b][axis];
+                             });
+        }
+    }
+
+    Proxy const first = build(leaves, middle);
+    Proxy const second = build(leaves + middle, count - middle);
+    Proxy const index = allocateNode();
+
+    nodes[index].children[0] = first;
+    nodes[index].children[1] = second;
+    nodes[index].height = 1 + std::max(nodes[first].height,
+                                       nodes[second].height);
+    setBox(index, merged(nodes[first].box, nodes[second].box));
+
+    nodes[first].parent = index;
+    nodes[second].parent = index;
+    return index;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,223 @@
+#ifndef AABB_TREE_H
+#define AABB_TREE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// ///////////////////////////////////////////////////// Class: AabbTree //
+// Dynamic bounding volume hierarchy over axis-aligned boxes. Leaves hold
+// "fat" boxes enlarged by a margin, so objects moving a little do not
+// touch the tree at all. A leaf that leaves its fat box is resized in
+// place and flags its ancestors; refit() then recomputes every flagged
+// box once, lowest nodes first. Inserts pick the sibling with the lowest
+// surface-area cost and keep the tree balanced with rotations. For
+// content that has stopped moving, rebuild() builds the whole tree again
+// top-down with the binned surface area heuristic.
+class AabbTree {
+public:
+    using Proxy = std::uint32_t;
+    static Proxy const NONE = UINT32_MAX;
+
+    struct RayHit {
+        std::uint32_t userData;
+        float distance;
+    };
+
+    explicit AabbTree(float margin = 0.1f);
+
+    Proxy insert(BoundingBox const &box, std::uint32_t userData);
+    void remove(Proxy proxy);
+
+    // Returns true if the leaf left its fat box. The boxes above it are
+    // only brought up to date by refit(), which has to run before the
+    // next query.
+    bool update(Proxy proxy, BoundingBox const &box);
+    void refit();
+
+    void rebuild();
+    void clear();
+
+    std::uint32_t getUserData(Proxy proxy) const;
+    BoundingBox const &getFatBounds(Proxy proxy) const;
+
+    std::size_t size() const;
+    int getHeight() const;
+
+    // Summed surface area of the internal nodes - the expected cost of a
+    // query; grows as refits loosen the tree
+    float getCost() const;
+    float getCostAfterRebuild() const;
+
+    // ------------------------------------------------------ Queries -- //
+    // Calls callback(userData) for every leaf whose fat box intersects
+    // the frustum. Branches entirely inside are reported without further
+    // tests.
+    template <typename Callback>
+    void queryFrustum(Frustum const &frustum, Callback &&callback) const {
+        if (root == NONE) {
+            return;
+        }
+
+        TraversalStack stack;
+        stack.push(root);
+        while (!stack.empty()) {
+            std::uint32_t const entry = stack.pop();
+            Proxy const index = entry & ~INSIDE_FLAG;
+            std::uint32_t inside = entry & INSIDE_FLAG;
+            Node const &node = nodes[index];
+
+            if (!inside) {
+                if (!frustum.intersects(node.box)) {
+                    continue;
+                }
+                if (frustum.contains(node.box)) {
+                    inside = INSIDE_FLAG;
+                }
+            }
+
+            if (node.isLeaf()) {
+                callback(node.userData);
+            } else {
+                stack.push(node.children[0] | inside);
+                stack.push(node.children[1] | inside);
+            }
+        }
+    }
+
+    // Closest hit along the ray. callback(userData, maxDistance) tests
+    // the object itself and returns the hit distance, or a negative value
+    // for a miss; boxes farther than the closest hit so far are skipped.
+    // userData is NONE when nothing was hit.
+    template <typename Callback>
+    RayHit raycast(glm::vec3 const &origin, glm::vec3 const &direction,
+                   float const maxDistance, Callback &&callback) const {
+        RayHit hit{NONE, maxDistance};
+        if (root == NONE) {
+            return hit;
+        }
+
+        glm::vec3 const inverseDirection = 1.0f / direction;
+
+        TraversalStack stack;
+        stack.push(root);
+        while (!stack.empty()) {
+            Node const &node = nodes[stack.pop()];
+            float enter;
+            if (!node.box.intersectsSlabs(origin, inverseDirection,
+                                          hit.distance, enter)) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                float const distance = callback(node.userData, hit.distance);
+                if (distance >= 0.0f && distance <= hit.distance) {
+                    hit.userData = node.userData;
+                    hit.distance = distance;
+                }
+            } else {
+                stack.push(node.children[0]);
+                stack.push(node.children[1]);
+            }
+        }
+        return hit;
+    }
+
+private:
+    // Top bit of a stack entry: the subtree is known to be inside
+    static std::uint32_t const INSIDE_FLAG = 0x80000000u;
+    static std::size_t const SAH_BIN_COUNT = 16;
+
+    struct Node {
+        BoundingBox box;
+        // Parent, or the next free node while the node is unused
+        Proxy parent;
+        Proxy children[2];
+        std::uint32_t userData;
+        // Leaves are at height 0, free nodes at -1
+        int height;
+        bool refitPending;
+
+        bool isLeaf() const {
+            return children[0] == NONE;
+        }
+    };
+
+    // Depth-first stack kept on the call stack for any sensible tree
+    // height, spilling over to the heap only for degenerate ones
+    class TraversalStack {
+    public:
+        TraversalStack() : count(0) {}
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        void push(std::uint32_t const entry) {
+            if (count < INLINE_CAPACITY) {
+                entries[count] = entry;
+            } else {
+                overflow.push_back(entry);
+            }
+            ++count;
+        }
+
+        std::uint32_t pop() {
+            --count;
+            if (count < INLINE_CAPACITY) {
+                return entries[count];
+            }
+            std::uint32_t const entry = overflow.back();
+            overflow.pop_back();
+            return entry;
+        }
+
+    private:
+        static std::size_t const INLINE_CAPACITY = 256;
+
+        std::uint32_t entries[INLINE_CAPACITY];
+        std::vector<std::uint32_t> overflow;
+        std::size_t count;
+    };
+
+    std::vector<Node> nodes;
+    Proxy root;
+    Proxy firstFree;
+    std::size_t leafCount;
+    float margin;
+
+    float cost;
+    float costAfterRebuild;
+
+    // Internal nodes waiting for refit(), and scratch space for sorting
+    // them by height
+    std::vector<Proxy> refitQueue;
+    std::vector<Proxy> refitOrder;
+    std::vector<std::size_t> heightOffsets;
+
+    // Leaf centers, indexed like the nodes, while rebuild() runs
+    std::vector<glm::vec3> centers;
+
+    static float surfaceArea(BoundingBox const &box);
+    static BoundingBox merged(BoundingBox const &a, BoundingBox const &b);
+
+    Proxy allocateNode();
+    void freeNode(Proxy index);
+
+    void setBox(Proxy index, BoundingBox const &box);
+    void insertLeaf(Proxy leaf);
+    void removeLeaf(Proxy leaf);
+    void refitAncestors(Proxy index);
+    Proxy balance(Proxy index);
+
+    Proxy build(Proxy *leaves, std::size_t count);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // AABB_TREE_H
@@ -0,0 +1,79 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "allocation-counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::size_t;
+
+// ///////////////////////////////////////////////////////////// Counter //
+namespace {
+    std::atomic<size_t> allocationCount(0);
+
+    void *countedAllocate(size_t const size) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        void *pointer = std::malloc(size != 0 ? size : 1);
+        if (pointer == nullptr) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+}
+
+size_t getAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+// ////////////////////////////////////////////////// Replaced operators //
+void *operator new(size_t const size) {
+    return countedAllocate(size);
+}
+
+void *operator new[](size_t const size) {
+    return countedAllocate(size);
+}
+
+void *operator new(size_t const size, std::nothrow_t const &) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (std::bad_alloc const &) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t const size, std::nothrow_t const &) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (std::bad_alloc const &) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::nothrow_t const &) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::nothrow_t const &) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
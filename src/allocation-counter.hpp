@@ -0,0 +1,13 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include <cstddef>
+
+// /////////////////////////////////////////////////// Allocation counter //
+// Global operator new/delete are replaced to count every heap allocation
+// made by the program, so a frame can be checked for being
+// allocation-free.
+std::size_t getAllocationCount();
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // ALLOCATION_COUNTER_H
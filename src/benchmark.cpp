@@ -0,0 +1,454 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "benchmark.hpp"
+#include "aabb-tree.hpp"
+#include "geometry-buffer.hpp"
+#include "gl-state.hpp"
+#include "instance-buffer.hpp"
+#include "matrix-kernels.hpp"
+#include "opengl-headers.hpp"
+#include "shader.hpp"
+#include "sphere-mesh.hpp"
+#include "task-scheduler.hpp"
+#include "transform-hierarchy.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::vec3;
+
+using std::size_t;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using benchmarkclock = std::chrono::steady_clock;
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    int const ITERATIONS = 20;
+    std::size_t const BRANCHING = 8;
+    std::size_t const RAYS_PER_FRAME = 100;
+
+    // Most the geometry shader in res/shaders/sphere can emit within its
+    // max_vertices
+    int const GEOMETRY_SHADER_LEVEL_MAX = 7;
+    int const GEOMETRY_SHADER_LEVEL_STEP = 2;
+    GLsizei const RENDER_TARGET_SIZE = 512;
+
+    // Random hierarchy where every level has BRANCHING times more nodes
+    // than the previous one
+    TransformHierarchy makeSyntheticScene(size_t const nodeCount) {
+        TransformHierarchy hierarchy;
+        std::mt19937 random(216920);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+        for (size_t i = 0; i < nodeCount; ++i) {
+            Transform const local =
+                    Transform::fromTranslation(vec3(offset(random),
+                                                    offset(random),
+                                                    offset(random))) *
+                    Transform::fromRotation(offset(random),
+                                            vec3(0.0f, 1.0f, 0.0f));
+
+            hierarchy.add(i == 0 ? TransformHierarchy::NO_PARENT
+                                 : static_cast<TransformHierarchy::Index>(
+                                           (i - 1) / BRANCHING),
+                          local);
+        }
+
+        return hierarchy;
+    }
+
+    // Touching the root dirties every node below it
+    void dirtyAll(TransformHierarchy &hierarchy) {
+        hierarchy.setLocal(0, hierarchy.getLocal(0));
+    }
+
+    // Affine, as in the transform hierarchy, so every kernel variant can
+    // take them
+    vector<mat4> makeRandomMatrices(size_t const count,
+                                    std::mt19937 &random) {
+        std::uniform_real_distribution<float> element(-1.0f, 1.0f);
+
+        vector<mat4> matrices(count);
+        for (auto &matrix : matrices) {
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 3; ++row) {
+                    matrix[column][row] = element(random);
+                }
+                matrix[column][3] = column == 3 ? 1.0f : 0.0f;
+            }
+        }
+        return matrices;
+    }
+
+    template <typename Function>
+    double timeIterations(Function &&function) {
+        // Warm up caches before timing
+        function();
+
+        auto const start = benchmarkclock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+            function();
+        }
+        return milliseconds(benchmarkclock::now() - start).count() /
+               ITERATIONS;
+    }
+
+    // Same as timeIterations, but GPU time from a timer query
+    template <typename Function>
+    double timeGpuIterations(Function &&function) {
+        GLuint query;
+        glGenQueries(1, &query);
+
+        function();
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        for (int i = 0; i < ITERATIONS; ++i) {
+            function();
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        glDeleteQueries(1, &query);
+
+        return nanoseconds / 1.0e6 / ITERATIONS;
+    }
+
+    string objectLabel(size_t const objectCount, char const *what) {
+        stringstream label;
+        label << objectCount << " obiektow - " << what;
+        return label.str();
+    }
+
+    string sphereLabel(int const level, char const *path) {
+        stringstream label;
+        label << "Kula, poziom " << level << " - " << path;
+        return label.str();
+    }
+
+    string threadLabel(unsigned const threadCount, double const speedup) {
+        stringstream label;
+        label.precision(2);
+        label << std::fixed
+              << "Watki: " << threadCount << " (x" << speedup << ")";
+        return label.str();
+    }
+}
+
+// ////////////////////////////////////////////////////////// Benchmarks //
+vector<BenchmarkResult> benchmarkTaskScheduler(size_t const nodeCount,
+                                               unsigned const maxThreadCount) {
+    TransformHierarchy hierarchy = makeSyntheticScene(nodeCount);
+    vector<BenchmarkResult> results;
+    double singleThreaded = 0.0;
+
+    // The single linear pass update() picks for one thread, on its own
+    // row: the speedups below compare the level-by-level path with itself
+    results.push_back({"Jeden przebieg liniowy", timeIterations([&]() {
+        dirtyAll(hierarchy);
+        hierarchy.update();
+    })});
+
+    for (unsigned threads = 1; threads <= maxThreadCount; ++threads) {
+        TaskScheduler scheduler(threads - 1);
+
+        double const time = timeIterations([&]() {
+            dirtyAll(hierarchy);
+            hierarchy.updateByLevel(scheduler);
+        });
+
+        if (threads == 1) {
+            singleThreaded = time;
+        }
+        results.push_back({threadLabel(threads, singleThreaded / time), time});
+    }
+
+    return results;
+}
+
+vector<BenchmarkResult> benchmarkMatrixKernels(size_t const matrixCount) {
+    std::mt19937 random(216920);
+    vector<mat4> const lhs = makeRandomMatrices(matrixCount, random);
+    vector<mat4> const rhs = makeRandomMatrices(matrixCount, random);
+    vector<mat4> products(matrixCount);
+
+    vector<mat4 const *> lhsPointers(matrixCount), rhsPointers(matrixCount);
+    vector<mat4 *> productPointers(matrixCount);
+    for (size_t i = 0; i < matrixCount; ++i) {
+        lhsPointers[i] = &lhs[i];
+        rhsPointers[i] = &rhs[i];
+        productPointers[i] = &products[i];
+    }
+
+    vector<BenchmarkResult> results;
+    results.push_back({"glm", timeIterations([&]() {
+        for (size_t i = 0; i < matrixCount; ++i) {
+            products[i] = lhs[i] * rhs[i];
+        }
+    })});
+
+    for (auto const &kernel : getAvailableMatrixKernels()) {
+        results.push_back({kernel.name, timeIterations([&]() {
+            kernel.multiply(lhsPointers.data(), rhsPointers.data(),
+                            productPointers.data(), matrixCount);
+        })});
+        results.push_back({string(kernel.name) + " (afiniczne)",
+                           timeIterations([&]() {
+            kernel.multiplyAffine(lhsPointers.data(), rhsPointers.data(),
+                                  productPointers.data(), matrixCount);
+        })});
+    }
+
+    return results;
+}
+
+vector<BenchmarkResult> benchmarkAabbTree(size_t const minObjectCount,
+                                          size_t const maxObjectCount) {
+    vector<BenchmarkResult> results;
+
+    for (size_t count = minObjectCount; count <= maxObjectCount;
+         count *= 10) {
+        // Same density for every count: the scene grows with the cube
+        // root of the number of objects
+        float const extent = 2.0f * std::cbrt(static_cast<float>(count));
+
+        std::mt19937 random(216920);
+        std::uniform_real_distribution<float> position(-extent, extent);
+        std::uniform_real_distribution<float> size(0.1f, 0.5f);
+        std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+
+        vector<BoundingBox> boxes(count);
+        vector<vec3> velocities(count);
+        vector<AabbTree::Proxy> proxies(count);
+
+        AabbTree tree;
+        for (size_t i = 0; i < count; ++i) {
+            vec3 const center(position(random), position(random),
+                              position(random));
+            vec3 const halfSize(size(random));
+            boxes[i] = BoundingBox(center - halfSize, center + halfSize);
+            velocities[i] = vec3(speed(random), speed(random),
+                                 speed(random));
+            proxies[i] = tree.insert(boxes[i], static_cast<std::uint32_t>(i));
+        }
+
+        // Rebuilding is not a per-frame cost, a single run is enough
+        auto const rebuildStart = benchmarkclock::now();
+        tree.rebuild();
+        results.push_back({objectLabel(count, "przebudowa SAH"),
+                           milliseconds(benchmarkclock::now() -
+                                        rebuildStart).count()});
+
+        results.push_back({objectLabel(count, "odswiezenie"),
+                           timeIterations([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                boxes[i].min += velocities[i];
+                boxes[i].max += velocities[i];
+                tree.update(proxies[i], boxes[i]);
+            }
+            tree.refit();
+        })});
+
+        // Camera in the middle of the cloud, looking along +x
+        Frustum const frustum(
+                glm::perspective(glm::radians(60.0f), 16.0f / 9.0f,
+                                 0.01f, extent) *
+                glm::lookAt(vec3(0.0f), vec3(1.0f, 0.0f, 0.0f),
+                            vec3(0.0f, 1.0f, 0.0f)));
+
+        size_t visible = 0;
+        results.push_back({objectLabel(count, "frustum"),
+                           timeIterations([&]() {
+            visible = 0;
+            tree.queryFrustum(frustum, [&](std::uint32_t) { ++visible; });
+        })});
+
+        vector<vec3> directions(RAYS_PER_FRAME);
+        std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+        for (auto &direction : directions) {
+            direction = glm::normalize(vec3(component(random),
+                                            component(random),
+                                            component(random)));
+        }
+
+        stringstream rayLabel;
+        rayLabel << RAYS_PER_FRAME << " promieni";
+        results.push_back({objectLabel(count, rayLabel.str().c_str()),
+                           timeIterations([&]() {
+            for (auto const &direction : directions) {
+                tree.raycast(vec3(0.0f), direction, extent,
+                             [&](std::uint32_t const index, float) {
+                                 float distance;
+                                 return boxes[index].intersectsRay(
+                                         vec3(0.0f), direction, distance)
+                                        ? distance : -1.0f;
+                             });
+            }
+        })});
+    }
+
+    return results;
+}
+
+vector<BenchmarkResult> benchmarkSphereRendering(size_t const sphereCount,
+                                                 int const maxLevel) {
+    // Off-screen target, so the frame on screen is left alone
+    GLint viewport[4];
+    glstate::getViewport(viewport);
+
+    GLuint framebuffer, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8,
+                          RENDER_TARGET_SIZE, RENDER_TARGET_SIZE);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24,
+                          RENDER_TARGET_SIZE, RENDER_TARGET_SIZE);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, depthBuffer);
+
+    glstate::viewport(0, 0, RENDER_TARGET_SIZE, RENDER_TARGET_SIZE);
+    glstate::enable(GL_DEPTH_TEST);
+    glstate::polygonMode(GL_FILL);
+
+    // Buffers and shaders are gone by the time the target is deleted
+    vector<BenchmarkResult> results;
+    {
+        // The point the geometry shader expands, then the meshes
+        GeometryBuffer geometry;
+        GeometryRange const point =
+                geometry.add({{vec3(0.0f), glm::vec2(0.0f)}}, {0});
+
+        vector<int> levels;
+        for (int level = 1; level <= GEOMETRY_SHADER_LEVEL_MAX;
+             level += GEOMETRY_SHADER_LEVEL_STEP) {
+            levels.push_back(level);
+        }
+        levels.push_back(maxLevel);
+
+        vector<GeometryRange> meshes;
+        vector<Vertex> vertices;
+        vector<unsigned int> indices;
+        for (int const level : levels) {
+            generateSphereMesh(level, vertices, indices);
+            meshes.push_back(geometry.add(vertices, indices));
+        }
+
+        generateSpherePatches(SPHERE_PATCH_SUBDIVISION_LEVEL,
+                              vertices, indices);
+        GeometryRange const patches = geometry.add(vertices, indices);
+
+        // A square grid of spheres filling clip space
+        int const side = static_cast<int>(
+                std::ceil(std::sqrt(static_cast<double>(sphereCount))));
+        float const spacing = 2.0f / side;
+
+        InstanceBuffer instances;
+        mat4 *const worlds = instances.map(sphereCount);
+        for (size_t i = 0; i < sphereCount; ++i) {
+            vec3 const center(-1.0f + spacing * (i % side + 0.5f),
+                              -1.0f + spacing * (i / side + 0.5f),
+                              0.0f);
+            worlds[i] = glm::scale(glm::translate(mat4(1.0f), center),
+                                   vec3(0.5f * spacing));
+        }
+        instances.unmap();
+
+        glstate::bindVertexArray(geometry.getVertexArray());
+        instances.bind();
+
+        Shader geometryShaderPath("res/shaders/sphere/vertex.glsl",
+                                  "res/shaders/sphere/geometry.glsl",
+                                  "res/shaders/sphere/fragment.glsl");
+        Shader meshPath("res/shaders/model/vertex.glsl",
+                        "res/shaders/model/geometry.glsl",
+                        "res/shaders/model/fragment.glsl");
+        Shader impostorPath("res/shaders/sphere/vertex.glsl",
+                            "res/shaders/impostor/geometry.glsl",
+                            "res/shaders/impostor/fragment.glsl");
+        Shader tessellationPath("res/shaders/tessellation/vertex.glsl",
+                                "res/shaders/tessellation/control.glsl",
+                                "res/shaders/tessellation/evaluation.glsl",
+                                "res/shaders/model/fragment.glsl");
+
+        mat4 const viewProjection(1.0f);
+        for (Shader *const shader : {&geometryShaderPath, &meshPath,
+                                     &impostorPath, &tessellationPath}) {
+            shader->use();
+            shader->uniformMatrix4fv("viewProjection",
+                                     glm::value_ptr(viewProjection));
+            shader->uniform1i("texture0", 0);
+        }
+        tessellationPath.uniform1f("viewportHeight",
+                                   static_cast<float>(RENDER_TARGET_SIZE));
+        glPatchParameteri(GL_PATCH_VERTICES, 4);
+
+        auto const draw = [&](GLenum const mode,
+                              GeometryRange const &range) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glDrawElementsInstancedBaseVertex(
+                    mode, range.indexCount, GL_UNSIGNED_INT,
+                    reinterpret_cast<void const *>(
+                            range.firstIndex * sizeof(unsigned int)),
+                    static_cast<GLsizei>(sphereCount), range.baseVertex);
+        };
+
+        for (size_t i = 0; i < levels.size(); ++i) {
+            if (levels[i] <= GEOMETRY_SHADER_LEVEL_MAX) {
+                geometryShaderPath.use();
+                geometryShaderPath.uniform1i("subdivisionLevelHorizontal",
+                                             levels[i] + 2);
+                geometryShaderPath.uniform1i("subdivisionLevelVertical",
+                                             levels[i] + 1);
+                results.push_back({sphereLabel(levels[i],
+                                               "shader geometrii"),
+                                   timeGpuIterations([&]() {
+                    draw(GL_POINTS, point);
+                })});
+            }
+
+            meshPath.use();
+            results.push_back({sphereLabel(levels[i], "siatka"),
+                               timeGpuIterations([&]() {
+                draw(GL_TRIANGLES, meshes[i]);
+            })});
+        }
+
+        impostorPath.use();
+        results.push_back({"Kula - impostor", timeGpuIterations([&]() {
+            draw(GL_POINTS, point);
+        })});
+
+        tessellationPath.use();
+        results.push_back({"Kula - teselacja", timeGpuIterations([&]() {
+            draw(GL_PATCHES, patches);
+        })});
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    glstate::viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    return results;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,41 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+// //////////////////////////////////////////////////////////// Includes //
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// //////////////////////////////////////////// Struct: BenchmarkResult //
+struct BenchmarkResult {
+    std::string label;
+    double milliseconds;
+};
+
+// ////////////////////////////////////////////////////////// Benchmarks //
+// Full world-matrix update of a synthetic TransformHierarchy, level by
+// level with 1 to maxThreadCount threads, plus the single-threaded linear
+// pass for reference
+std::vector<BenchmarkResult> benchmarkTaskScheduler(std::size_t nodeCount,
+                                                    unsigned maxThreadCount);
+
+// Batched products of affine 4x4 matrices through every available matrix
+// kernel, general and affine, compared against a plain loop of glm
+// products
+std::vector<BenchmarkResult> benchmarkMatrixKernels(std::size_t matrixCount);
+
+// Per-frame cost of an AabbTree over moving boxes - refit, frustum query
+// and ray casts - for minObjectCount up to maxObjectCount objects in
+// steps of ten
+std::vector<BenchmarkResult> benchmarkAabbTree(std::size_t minObjectCount,
+                                               std::size_t maxObjectCount);
+
+// GPU time of sphereCount instanced spheres drawn off-screen, expanded
+// from a point by the geometry shader and as prebuilt meshes, for the
+// levels the geometry shader can reach and for maxLevel (meshes only),
+// and once each as ray-cast impostors and as patches tessellated by
+// screen size, which pick no level. Needs the OpenGL context to be current.
+std::vector<BenchmarkResult> benchmarkSphereRendering(std::size_t sphereCount,
+                                                      int maxLevel);
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // BENCHMARK_H
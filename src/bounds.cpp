@@ -0,0 +1,208 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::vec3;
+using glm::vec4;
+
+// ///////////////////////////////////////////////// Struct: BoundingBox //
+BoundingBox::BoundingBox()
+        : min(std::numeric_limits<float>::max()),
+          max(-std::numeric_limits<float>::max()) {
+}
+
+BoundingBox::BoundingBox(vec3 const &min, vec3 const &max)
+        : min(min),
+          max(max) {
+}
+
+bool BoundingBox::isEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+vec3 BoundingBox::getCenter() const {
+    return 0.5f * (min + max);
+}
+
+vec3 BoundingBox::getExtents() const {
+    return 0.5f * (max - min);
+}
+
+void BoundingBox::extend(vec3 const &point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void BoundingBox::extend(BoundingBox const &box) {
+    min = glm::min(min, box.min);
+    max = glm::max(max, box.max);
+}
+
+BoundingBox BoundingBox::transformed(mat4 const &transform) const {
+    if (isEmpty()) {
+        return BoundingBox();
+    }
+
+    // Center and half-extents form: the new extents are the old ones
+    // projected onto the absolute values of the transform's axes
+    vec3 const center = vec3(transform * vec4(getCenter(), 1.0f));
+    vec3 const extents = getExtents();
+
+    vec3 const newExtents =
+            glm::abs(vec3(transform[0])) * extents.x +
+            glm::abs(vec3(transform[1])) * extents.y +
+            glm::abs(vec3(transform[2])) * extents.z;
+
+    return BoundingBox(center - newExtents, center + newExtents);
+}
+
+bool BoundingBox::intersectsRay(vec3 const &origin, vec3 const &direction,
+                                float &distance) const {
+    if (isEmpty()) {
+        return false;
+    }
+
+    return intersectsSlabs(origin, 1.0f / direction,
+                           std::numeric_limits<float>::infinity(), distance);
+}
+
+bool BoundingBox::intersectsSlabs(vec3 const &origin,
+                                  vec3 const &inverseDirection,
+                                  float const maxDistance,
+                                  float &distance) const {
+    float enter = 0.0f,
+          exit = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (std::isinf(inverseDirection[axis])) {
+            if (origin[axis] < min[axis] || origin[axis] > max[axis]) {
+                return false;
+            }
+            continue;
+        }
+
+        float const t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+        float const t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+        enter = std::max(enter, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+
+    distance = enter;
+    return enter <= exit;
+}
+
+// ////////////////////////////////////////////// Struct: BoundingSphere //
+BoundingSphere::BoundingSphere()
+        : center(0.0f),
+          radius(-1.0f) {
+}
+
+BoundingSphere::BoundingSphere(vec3 const &center, float const radius)
+        : center(center),
+          radius(radius) {
+}
+
+bool BoundingSphere::isEmpty() const {
+    return radius < 0.0f;
+}
+
+BoundingSphere BoundingSphere::transformed(mat4 const &transform) const {
+    if (isEmpty()) {
+        return BoundingSphere();
+    }
+
+    float const scale = std::sqrt(std::max({
+            glm::dot(vec3(transform[0]), vec3(transform[0])),
+            glm::dot(vec3(transform[1]), vec3(transform[1])),
+            glm::dot(vec3(transform[2]), vec3(transform[2]))}));
+
+    return BoundingSphere(vec3(transform * vec4(center, 1.0f)),
+                          radius * scale);
+}
+
+// ////////////////////////////////////////////////////// Class: Frustum //
+Frustum::Frustum(mat4 const &viewProjection) {
+    // Gribb-Hartmann: each plane is the last row of the matrix plus or
+    // minus one of the others (glm stores columns, so rows are gathered)
+    vec4 rows[4];
+    for (int row = 0; row < 4; ++row) {
+        rows[row] = vec4(viewProjection[0][row], viewProjection[1][row],
+                         viewProjection[2][row], viewProjection[3][row]);
+    }
+
+    planes[0] = rows[3] + rows[0];  // Left
+    planes[1] = rows[3] - rows[0];  // Right
+    planes[2] = rows[3] + rows[1];  // Bottom
+    planes[3] = rows[3] - rows[1];  // Top
+    planes[4] = rows[3] + rows[2];  // Near
+    planes[5] = rows[3] - rows[2];  // Far
+
+    for (auto &plane : planes) {
+        plane /= glm::length(vec3(plane));
+    }
+}
+
+bool Frustum::intersects(BoundingBox const &box) const {
+    if (box.isEmpty()) {
+        return false;
+    }
+
+    vec3 const center = box.getCenter();
+    vec3 const extents = box.getExtents();
+
+    // The box is outside as soon as it lies entirely behind one plane
+    for (auto const &plane : planes) {
+        vec3 const normal(plane);
+        float const distance = glm::dot(normal, center) + plane.w;
+        float const reach = glm::dot(glm::abs(normal), extents);
+
+        if (distance + reach < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::contains(BoundingBox const &box) const {
+    if (box.isEmpty()) {
+        return false;
+    }
+
+    vec3 const center = box.getCenter();
+    vec3 const extents = box.getExtents();
+
+    for (auto const &plane : planes) {
+        vec3 const normal(plane);
+        float const distance = glm::dot(normal, center) + plane.w;
+        float const reach = glm::dot(glm::abs(normal), extents);
+
+        if (distance - reach < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vec4 const *Frustum::getPlanes() const {
+    return planes;
+}
+
+bool Frustum::intersects(BoundingSphere const &sphere) const {
+    if (sphere.isEmpty()) {
+        return false;
+    }
+
+    for (auto const &plane : planes) {
+        if (glm::dot(vec3(plane), sphere.center) + plane.w <
+            -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,80 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "glm/glm.hpp"
+
+// ///////////////////////////////////////////////// Struct: BoundingBox //
+// Axis-aligned box; a default-constructed box is empty and grows as
+// points or other boxes are added to it
+struct BoundingBox {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    BoundingBox();
+    BoundingBox(glm::vec3 const &min, glm::vec3 const &max);
+
+    bool isEmpty() const;
+
+    glm::vec3 getCenter() const;
+    glm::vec3 getExtents() const;
+
+    void extend(glm::vec3 const &point);
+    void extend(BoundingBox const &box);
+
+    // Box around this box after an affine transform
+    BoundingBox transformed(glm::mat4 const &transform) const;
+
+    // Slab test; distance is where the ray enters the box, or 0 when it
+    // starts inside
+    bool intersectsRay(glm::vec3 const &origin, glm::vec3 const &direction,
+                       float &distance) const;
+
+    // The same for a ray given by 1 / direction, cut off at maxDistance,
+    // so a ray tested against many boxes divides once. An infinite
+    // component - a ray parallel to that axis - hits only from within the
+    // box's extent on it; the slab formula would give 0 * inf = NaN for
+    // an origin on the box's face.
+    bool intersectsSlabs(glm::vec3 const &origin,
+                         glm::vec3 const &inverseDirection,
+                         float maxDistance, float &distance) const;
+};
+
+// ////////////////////////////////////////////// Struct: BoundingSphere //
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+
+    BoundingSphere();
+    BoundingSphere(glm::vec3 const &center, float radius);
+
+    bool isEmpty() const;
+
+    // Sphere around this sphere after an affine transform - the radius
+    // grows with the largest axis scale
+    BoundingSphere transformed(glm::mat4 const &transform) const;
+};
+
+// ////////////////////////////////////////////////////// Class: Frustum //
+// Six clip planes taken from a view-projection matrix, normals pointing
+// inwards. The tests are conservative: objects near a frustum corner may
+// be reported visible although they are not.
+class Frustum {
+public:
+    explicit Frustum(glm::mat4 const &viewProjection);
+
+    bool intersects(BoundingBox const &box) const;
+    bool intersects(BoundingSphere const &sphere) const;
+
+    // True only if the box is entirely inside
+    bool contains(BoundingBox const &box) const;
+
+    // (normal, distance) each, in the order left, right, bottom, top,
+    // near, far
+    glm::vec4 const *getPlanes() const;
+
+private:
+    glm::vec4 planes[6];
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // BOUNDS_H
@@ -0,0 +1,21 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "detail-level.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// //////////////////////////////////////////////// Detail level selection //
+int selectDetailLevel(float const screenSize, int const previousLevel,
+                      int const levelCount) {
+    // Continuous level: 0 at the full detail size, +1 per halving
+    float const ideal = std::log2(DETAIL_FULL_SIZE / screenSize);
+
+    if (ideal >= previousLevel - DETAIL_HYSTERESIS &&
+        ideal <= previousLevel + 1 + DETAIL_HYSTERESIS) {
+        return previousLevel;
+    }
+    return static_cast<int>(std::floor(std::min(
+            std::max(ideal, 0.0f), static_cast<float>(levelCount - 1))));
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,18 @@
+#ifndef DETAIL_LEVEL_H
+#define DETAIL_LEVEL_H
+// //////////////////////////////////////////////// Detail level selection //
+// Share of the screen height below which detail starts to drop
+float const DETAIL_FULL_SIZE = 0.25f;
+// How far, in levels, the share has to move past a level's range before
+// the level changes
+float const DETAIL_HYSTERESIS = 0.2f;
+
+// Detail level for a bounding sphere covering screenSize of the screen
+// height: full detail (0) above DETAIL_FULL_SIZE, one level coarser each
+// time that share halves, at most levelCount - 1. previousLevel, the level
+// last drawn, is kept until the share leaves its range by
+// DETAIL_HYSTERESIS, so an object does not flicker between two levels.
+int selectDetailLevel(float screenSize, int previousLevel, int levelCount);
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // DETAIL_LEVEL_H
@@ -0,0 +1,73 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "frame-arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::size_t;
+using std::unique_ptr;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    size_t alignUp(size_t const value, size_t const alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// /////////////////////////////////////////////////// Class: FrameArena //
+FrameArena::FrameArena(size_t const capacity)
+        : memory(new unsigned char[capacity]),
+          capacity(capacity),
+          offset(0),
+          overflowSize(0),
+          peak(0) {
+}
+
+void *FrameArena::allocate(size_t const size, size_t const alignment) {
+    // Align the actual address, the block itself is only aligned to
+    // max_align_t
+    std::uintptr_t const base = reinterpret_cast<std::uintptr_t>(memory.get());
+    size_t const start = alignUp(base + offset, alignment) - base;
+
+    if (start + size <= capacity) {
+        offset = start + size;
+        peak = std::max(peak, offset + overflowSize);
+        return memory.get() + start;
+    }
+
+    // Out of space - serve the request from a separate block and remember
+    // to grow on the next reset
+    overflow.emplace_back(new unsigned char[size + alignment]);
+    overflowSize += size + alignment;
+    peak = std::max(peak, offset + overflowSize);
+
+    std::uintptr_t const block =
+            reinterpret_cast<std::uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void *>(alignUp(block, alignment));
+}
+
+void FrameArena::reset() {
+    if (!overflow.empty()) {
+        overflow.clear();
+        overflowSize = 0;
+
+        capacity = std::max(capacity * 2, peak);
+        memory.reset(new unsigned char[capacity]);
+    }
+    offset = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    return capacity;
+}
+
+size_t FrameArena::getUsed() const {
+    return offset + overflowSize;
+}
+
+size_t FrameArena::getPeak() const {
+    return peak;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
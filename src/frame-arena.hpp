@@ -0,0 +1,87 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+// //////////////////////////////////////////////////////////// Includes //
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// /////////////////////////////////////////////////// Class: FrameArena //
+// Linear (bump) allocator for data that lives for a single frame. Memory
+// is handed out by advancing an offset and released all at once by
+// reset(). When a frame outgrows the arena, the overflow goes to extra
+// blocks and the next reset() replaces everything with one block big
+// enough for the peak, so the steady state does not touch the heap.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity);
+
+    FrameArena(FrameArena const &) = delete;
+    FrameArena &operator=(FrameArena const &) = delete;
+
+    void *allocate(std::size_t size,
+                   std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T *allocateArray(std::size_t const count) {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+
+    std::size_t getCapacity() const;
+    std::size_t getUsed() const;
+    std::size_t getPeak() const;
+
+private:
+    std::unique_ptr<unsigned char[]> memory;
+    std::size_t capacity;
+    std::size_t offset;
+
+    std::vector<std::unique_ptr<unsigned char[]>> overflow;
+    std::size_t overflowSize;
+
+    std::size_t peak;
+};
+
+// ///////////////////////////////////////////// Class: ArenaAllocator //
+// Adapter letting standard containers allocate from a FrameArena. Freeing
+// is a no-op - the memory comes back with the next FrameArena::reset().
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena &arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const &other) : arena(other.arena) {}
+
+    T *allocate(std::size_t const count) {
+        return arena->allocateArray<T>(count);
+    }
+
+    void deallocate(T *, std::size_t) {}
+
+    template <typename U>
+    bool operator==(ArenaAllocator<U> const &other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(ArenaAllocator<U> const &other) const {
+        return arena != other.arena;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena *arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // FRAME_ARENA_H
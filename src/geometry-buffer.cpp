@@ -0,0 +1,163 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "geometry-buffer.hpp"
+#include "gl-state.hpp"
+#include "instance-buffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Replaces buffer with a larger one holding the same first usedSize
+    // bytes
+    void growBuffer(GLuint &buffer, std::size_t const usedSize,
+                    std::size_t const newSize) {
+        GLuint replacement;
+        glGenBuffers(1, &replacement);
+        glstate::bindBuffer(GL_COPY_WRITE_BUFFER, replacement);
+        glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+
+        if (usedSize > 0) {
+            glstate::bindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                0, 0, usedSize);
+        }
+
+        glstate::deleteBuffer(buffer);
+        buffer = replacement;
+    }
+}
+
+// /////////////////////////////////////////////// Class: GeometryBuffer //
+std::size_t const GeometryBuffer::INITIAL_VERTEX_CAPACITY;
+std::size_t const GeometryBuffer::INITIAL_INDEX_CAPACITY;
+GLuint const GeometryBuffer::VERTEX_BINDING;
+
+GeometryBuffer::GeometryBuffer()
+        : vao(0), vbo(0), ebo(0),
+          vertexCount(0), vertexCapacity(0),
+          indexCount(0), indexCapacity(0) {
+    glGenVertexArrays(1, &vao);
+
+    glstate::bindVertexArray(vao); {
+        glEnableVertexAttribArray(0);
+        glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE,
+                             offsetof(Vertex, position));
+        glVertexAttribBinding(0, VERTEX_BINDING);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribFormat(1, 2, GL_FLOAT, GL_FALSE,
+                             offsetof(Vertex, texCoords));
+        glVertexAttribBinding(1, VERTEX_BINDING);
+
+        InstanceBuffer::setupVertexArray();
+    }
+
+    // Creates both buffers
+    reserve(INITIAL_VERTEX_CAPACITY, INITIAL_INDEX_CAPACITY);
+}
+
+GeometryBuffer::~GeometryBuffer() {
+    glstate::deleteBuffer(ebo);
+    glstate::deleteBuffer(vbo);
+    glstate::deleteVertexArray(vao);
+}
+
+GeometryRange GeometryBuffer::add(vector<Vertex> const &vertices,
+                                  vector<unsigned int> const &indices) {
+    return add(vertices.data(), vertices.size(),
+               indices.data(), indices.size());
+}
+
+GeometryRange GeometryBuffer::addIndices(GLint const baseVertex,
+                                         vector<unsigned int> const &indices) {
+    return addIndices(baseVertex, indices.data(), indices.size());
+}
+
+GeometryRange GeometryBuffer::add(Vertex const *const vertices,
+                                  std::size_t const verticesSize,
+                                  unsigned int const *const indices,
+                                  std::size_t const indicesSize) {
+    reserve(vertexCount + verticesSize, indexCount + indicesSize);
+
+    GLint const baseVertex = static_cast<GLint>(vertexCount);
+
+    // Copy targets leave the array buffer and the element buffer of
+    // whatever vertex array is bound alone
+    if (verticesSize > 0) {
+        glstate::bindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, vertexCount * sizeof(Vertex),
+                        verticesSize * sizeof(Vertex), vertices);
+    }
+    vertexCount += verticesSize;
+
+    return addIndices(baseVertex, indices, indicesSize);
+}
+
+GeometryRange GeometryBuffer::addIndices(GLint const baseVertex,
+                                         unsigned int const *const indices,
+                                         std::size_t const indicesSize) {
+    reserve(vertexCount, indexCount + indicesSize);
+
+    GeometryRange const range = {static_cast<GLuint>(indexCount),
+                                 baseVertex,
+                                 static_cast<GLsizei>(indicesSize)};
+
+    if (indicesSize > 0) {
+        glstate::bindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        indexCount * sizeof(unsigned int),
+                        indicesSize * sizeof(unsigned int), indices);
+    }
+
+    indexCount += indicesSize;
+    return range;
+}
+
+GLuint GeometryBuffer::getVertexArray() const {
+    return vao;
+}
+
+std::size_t GeometryBuffer::getVertexCount() const {
+    return vertexCount;
+}
+
+std::size_t GeometryBuffer::getIndexCount() const {
+    return indexCount;
+}
+
+void GeometryBuffer::reserve(std::size_t const vertices,
+                             std::size_t const indices) {
+    bool grown = false;
+
+    if (vertices > vertexCapacity) {
+        std::size_t const capacity = std::max(vertices, 2 * vertexCapacity);
+        growBuffer(vbo, vertexCount * sizeof(Vertex),
+                   capacity * sizeof(Vertex));
+        vertexCapacity = capacity;
+        grown = true;
+    }
+    if (indices > indexCapacity) {
+        std::size_t const capacity = std::max(indices, 2 * indexCapacity);
+        growBuffer(ebo, indexCount * sizeof(unsigned int),
+                   capacity * sizeof(unsigned int));
+        indexCapacity = capacity;
+        grown = true;
+    }
+
+    if (grown) {
+        attachBuffers();
+    }
+}
+
+void GeometryBuffer::attachBuffers() {
+    // Both bindings are vertex array state
+    glstate::bindVertexArray(vao);
+    glBindVertexBuffer(VERTEX_BINDING, vbo, 0, sizeof(Vertex));
+    glstate::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
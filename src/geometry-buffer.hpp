@@ -0,0 +1,74 @@
+#ifndef GEOMETRY_BUFFER_H
+#define GEOMETRY_BUFFER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// ////////////////////////////////////////////////////// Struct: Vertex //
+struct Vertex {
+    glm::vec3 position;
+    glm::vec2 texCoords;
+};
+
+// /////////////////////////////////////////////// Struct: GeometryRange //
+// Where a mesh lives inside a GeometryBuffer, in the terms of an indexed
+// draw with a base vertex
+struct GeometryRange {
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLsizei indexCount;
+};
+
+// /////////////////////////////////////////////// Class: GeometryBuffer //
+// Shared storage for static meshes in the Vertex format: one vertex
+// buffer, one index buffer and a single vertex array reading both, so
+// drawing any of the meshes needs no vertex array switch. Meshes are
+// appended and never freed - everything is loaded up front. A buffer
+// that runs out of room is reallocated at twice the size and the old
+// contents are copied over on the GPU.
+class GeometryBuffer {
+public:
+    GeometryBuffer();
+    ~GeometryBuffer();
+
+    GeometryBuffer(GeometryBuffer const &) = delete;
+    GeometryBuffer &operator=(GeometryBuffer const &) = delete;
+
+    // Indices are relative to the mesh's own vertices
+    GeometryRange add(std::vector<Vertex> const &vertices,
+                      std::vector<unsigned int> const &indices);
+    // Another index list over vertices added earlier, e.g. a simplified
+    // level of the same mesh
+    GeometryRange addIndices(GLint baseVertex,
+                             std::vector<unsigned int> const &indices);
+    // The same from plain arrays, e.g. straight out of a mapped file
+    GeometryRange add(Vertex const *vertices, std::size_t verticesSize,
+                      unsigned int const *indices, std::size_t indicesSize);
+    GeometryRange addIndices(GLint baseVertex,
+                             unsigned int const *indices,
+                             std::size_t indicesSize);
+
+    GLuint getVertexArray() const;
+    std::size_t getVertexCount() const;
+    std::size_t getIndexCount() const;
+
+private:
+    static std::size_t const INITIAL_VERTEX_CAPACITY = 64 * 1024;
+    static std::size_t const INITIAL_INDEX_CAPACITY = 192 * 1024;
+    static GLuint const VERTEX_BINDING = 0;
+
+    GLuint vao, vbo, ebo;
+
+    std::size_t vertexCount, vertexCapacity;
+    std::size_t indexCount, indexCapacity;
+
+    void reserve(std::size_t vertices, std::size_t indices);
+    void attachBuffers();
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // GEOMETRY_BUFFER_H
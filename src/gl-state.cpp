@@ -0,0 +1,422 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "gl-state.hpp"
+
+#include <cstdint>
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Value for names not known yet; no GL object ever has it
+    GLuint const UNKNOWN = UINT32_MAX;
+    // Capability state not known yet
+    int const UNKNOWN_CAPABILITY = -1;
+
+    // Units above this are passed through without caching
+    GLuint const TEXTURE_UNIT_COUNT = 16;
+
+    struct State {
+        GLuint program;
+        GLenum activeTexture;
+        GLuint textures[TEXTURE_UNIT_COUNT];
+        GLuint samplers[TEXTURE_UNIT_COUNT];
+        GLuint vertexArray;
+        GLuint arrayBuffer;
+
+        int blend;
+        int cullFace;
+        int depthTest;
+        int scissorTest;
+
+        GLenum blendEquation[2];
+        GLenum blendFunc[4];
+        GLenum polygonMode;
+
+        GLint viewport[4];
+        bool viewportKnown;
+        GLint scissor[4];
+        bool scissorKnown;
+    };
+
+    State state;
+    glstate::Statistics statistics = {0, 0};
+
+    // Counts the call and tells whether it has to reach the driver
+    bool filter(bool const redundant) {
+        if (redundant) {
+            ++statistics.filtered;
+            return false;
+        }
+        ++statistics.issued;
+        return true;
+    }
+
+    GLuint queryInteger(GLenum const name) {
+        GLint value;
+        glGetIntegerv(name, &value);
+        return static_cast<GLuint>(value);
+    }
+
+    // Cached flag of a capability, or nullptr for ones passed through
+    int *capability(GLenum const name) {
+        switch (name) {
+            case GL_BLEND:
+                return &state.blend;
+            case GL_CULL_FACE:
+                return &state.cullFace;
+            case GL_DEPTH_TEST:
+                return &state.depthTest;
+            case GL_SCISSOR_TEST:
+                return &state.scissorTest;
+            default:
+                return nullptr;
+        }
+    }
+
+    bool sameRectangle(GLint const (&values)[4], GLint const x, GLint const y,
+                       GLsizei const width, GLsizei const height) {
+        return values[0] == x && values[1] == y
+               && values[2] == width && values[3] == height;
+    }
+
+    void setRectangle(GLint (&values)[4], GLint const x, GLint const y,
+                      GLsizei const width, GLsizei const height) {
+        values[0] = x;
+        values[1] = y;
+        values[2] = width;
+        values[3] = height;
+    }
+
+    struct Initializer {
+        Initializer() {
+            glstate::invalidate();
+        }
+    } const initializer;
+}
+
+// ////////////////////////////////////////////////// Namespace: glstate //
+void glstate::invalidate() {
+    state.program = UNKNOWN;
+    state.activeTexture = UNKNOWN;
+    for (GLuint unit = 0; unit < TEXTURE_UNIT_COUNT; ++unit) {
+        state.textures[unit] = UNKNOWN;
+        state.samplers[unit] = UNKNOWN;
+    }
+    state.vertexArray = UNKNOWN;
+    state.arrayBuffer = UNKNOWN;
+
+    state.blend = UNKNOWN_CAPABILITY;
+    state.cullFace = UNKNOWN_CAPABILITY;
+    state.depthTest = UNKNOWN_CAPABILITY;
+    state.scissorTest = UNKNOWN_CAPABILITY;
+
+    state.blendEquation[0] = UNKNOWN;
+    state.blendEquation[1] = UNKNOWN;
+    for (auto &factor : state.blendFunc) {
+        factor = UNKNOWN;
+    }
+    state.polygonMode = UNKNOWN;
+
+    state.viewportKnown = false;
+    state.scissorKnown = false;
+}
+
+glstate::Statistics glstate::getStatistics() {
+    return statistics;
+}
+
+void glstate::resetStatistics() {
+    statistics = {0, 0};
+}
+
+// ---------------------------------------------------------- Binding -- //
+void glstate::useProgram(GLuint const program) {
+    if (filter(state.program == program)) {
+        glUseProgram(program);
+        state.program = program;
+    }
+}
+
+void glstate::activeTexture(GLenum const unit) {
+    if (filter(state.activeTexture == unit)) {
+        glActiveTexture(unit);
+        state.activeTexture = unit;
+    }
+}
+
+void glstate::bindTexture(GLenum const target, GLuint const texture) {
+    GLuint const unit = getActiveTexture() - GL_TEXTURE0;
+    if (target != GL_TEXTURE_2D || unit >= TEXTURE_UNIT_COUNT) {
+        filter(false);
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (filter(state.textures[unit] == texture)) {
+        glBindTexture(target, texture);
+        state.textures[unit] = texture;
+    }
+}
+
+void glstate::bindSampler(GLuint const unit, GLuint const sampler) {
+    if (unit >= TEXTURE_UNIT_COUNT) {
+        filter(false);
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if (filter(state.samplers[unit] == sampler)) {
+        glBindSampler(unit, sampler);
+        state.samplers[unit] = sampler;
+    }
+}
+
+void glstate::bindVertexArray(GLuint const vertexArray) {
+    if (filter(state.vertexArray == vertexArray)) {
+        glBindVertexArray(vertexArray);
+        state.vertexArray = vertexArray;
+    }
+}
+
+void glstate::bindBuffer(GLenum const target, GLuint const buffer) {
+    if (target != GL_ARRAY_BUFFER) {
+        filter(false);
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (filter(state.arrayBuffer == buffer)) {
+        glBindBuffer(target, buffer);
+        state.arrayBuffer = buffer;
+    }
+}
+
+// --------------------------------------------------- Fixed function -- //
+void glstate::enable(GLenum const capability) {
+    setEnabled(capability, true);
+}
+
+void glstate::disable(GLenum const capability) {
+    setEnabled(capability, false);
+}
+
+void glstate::setEnabled(GLenum const name, bool const enabled) {
+    int *const cached = capability(name);
+    int const value = enabled ? 1 : 0;
+
+    if (filter(cached != nullptr && *cached == value)) {
+        if (enabled) {
+            glEnable(name);
+        } else {
+            glDisable(name);
+        }
+        if (cached != nullptr) {
+            *cached = value;
+        }
+    }
+}
+
+void glstate::blendEquationSeparate(GLenum const modeRgb,
+                                    GLenum const modeAlpha) {
+    if (filter(state.blendEquation[0] == modeRgb
+               && state.blendEquation[1] == modeAlpha)) {
+        glBlendEquationSeparate(modeRgb, modeAlpha);
+        state.blendEquation[0] = modeRgb;
+        state.blendEquation[1] = modeAlpha;
+    }
+}
+
+void glstate::blendFuncSeparate(GLenum const sourceRgb,
+                                GLenum const destinationRgb,
+                                GLenum const sourceAlpha,
+                                GLenum const destinationAlpha) {
+    if (filter(state.blendFunc[0] == sourceRgb
+               && state.blendFunc[1] == destinationRgb
+               && state.blendFunc[2] == sourceAlpha
+               && state.blendFunc[3] == destinationAlpha)) {
+        glBlendFuncSeparate(sourceRgb, destinationRgb,
+                            sourceAlpha, destinationAlpha);
+        state.blendFunc[0] = sourceRgb;
+        state.blendFunc[1] = destinationRgb;
+        state.blendFunc[2] = sourceAlpha;
+        state.blendFunc[3] = destinationAlpha;
+    }
+}
+
+void glstate::polygonMode(GLenum const mode) {
+    if (filter(state.polygonMode == mode)) {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        state.polygonMode = mode;
+    }
+}
+
+void glstate::viewport(GLint const x, GLint const y,
+                       GLsizei const width, GLsizei const height) {
+    if (filter(state.viewportKnown
+               && sameRectangle(state.viewport, x, y, width, height))) {
+        glViewport(x, y, width, height);
+        setRectangle(state.viewport, x, y, width, height);
+        state.viewportKnown = true;
+    }
+}
+
+void glstate::scissor(GLint const x, GLint const y,
+                      GLsizei const width, GLsizei const height) {
+    if (filter(state.scissorKnown
+               && sameRectangle(state.scissor, x, y, width, height))) {
+        glScissor(x, y, width, height);
+        setRectangle(state.scissor, x, y, width, height);
+        state.scissorKnown = true;
+    }
+}
+
+// --------------------------------------------------------- Deletion -- //
+void glstate::deleteTexture(GLuint const texture) {
+    glDeleteTextures(1, &texture);
+    for (auto &bound : state.textures) {
+        if (bound == texture) {
+            bound = 0;
+        }
+    }
+}
+
+void glstate::deleteVertexArray(GLuint const vertexArray) {
+    glDeleteVertexArrays(1, &vertexArray);
+    if (state.vertexArray == vertexArray) {
+        state.vertexArray = 0;
+    }
+}
+
+void glstate::deleteBuffer(GLuint const buffer) {
+    glDeleteBuffers(1, &buffer);
+    if (state.arrayBuffer == buffer) {
+        state.arrayBuffer = 0;
+    }
+}
+
+void glstate::deleteProgram(GLuint const program) {
+    // A program in use stays current until another one replaces it, so
+    // the cached name is still right
+    glDeleteProgram(program);
+}
+
+// ---------------------------------------------------------- Getters -- //
+GLuint glstate::getProgram() {
+    if (state.program == UNKNOWN) {
+        state.program = queryInteger(GL_CURRENT_PROGRAM);
+    }
+    return state.program;
+}
+
+GLenum glstate::getActiveTexture() {
+    if (state.activeTexture == UNKNOWN) {
+        state.activeTexture = queryInteger(GL_ACTIVE_TEXTURE);
+    }
+    return state.activeTexture;
+}
+
+GLuint glstate::getTexture2D() {
+    GLuint const unit = getActiveTexture() - GL_TEXTURE0;
+    if (unit >= TEXTURE_UNIT_COUNT) {
+        return queryInteger(GL_TEXTURE_BINDING_2D);
+    }
+    if (state.textures[unit] == UNKNOWN) {
+        state.textures[unit] = queryInteger(GL_TEXTURE_BINDING_2D);
+    }
+    return state.textures[unit];
+}
+
+GLuint glstate::getSampler(GLuint const unit) {
+    if (unit >= TEXTURE_UNIT_COUNT || state.samplers[unit] == UNKNOWN) {
+        // The sampler binding is per unit, so the query needs that unit
+        // to be active
+        GLenum const previousUnit = getActiveTexture();
+        activeTexture(GL_TEXTURE0 + unit);
+        GLuint const sampler = queryInteger(GL_SAMPLER_BINDING);
+        activeTexture(previousUnit);
+
+        if (unit >= TEXTURE_UNIT_COUNT) {
+            return sampler;
+        }
+        state.samplers[unit] = sampler;
+    }
+    return state.samplers[unit];
+}
+
+GLuint glstate::getVertexArray() {
+    if (state.vertexArray == UNKNOWN) {
+        state.vertexArray = queryInteger(GL_VERTEX_ARRAY_BINDING);
+    }
+    return state.vertexArray;
+}
+
+GLuint glstate::getArrayBuffer() {
+    if (state.arrayBuffer == UNKNOWN) {
+        state.arrayBuffer = queryInteger(GL_ARRAY_BUFFER_BINDING);
+    }
+    return state.arrayBuffer;
+}
+
+bool glstate::isEnabled(GLenum const name) {
+    int *const cached = capability(name);
+    if (cached == nullptr) {
+        return glIsEnabled(name) == GL_TRUE;
+    }
+    if (*cached == UNKNOWN_CAPABILITY) {
+        *cached = glIsEnabled(name) == GL_TRUE ? 1 : 0;
+    }
+    return *cached == 1;
+}
+
+void glstate::getBlendEquation(GLenum &modeRgb, GLenum &modeAlpha) {
+    if (state.blendEquation[0] == UNKNOWN) {
+        state.blendEquation[0] = queryInteger(GL_BLEND_EQUATION_RGB);
+        state.blendEquation[1] = queryInteger(GL_BLEND_EQUATION_ALPHA);
+    }
+    modeRgb = state.blendEquation[0];
+    modeAlpha = state.blendEquation[1];
+}
+
+void glstate::getBlendFunc(GLenum &sourceRgb, GLenum &destinationRgb,
+                           GLenum &sourceAlpha, GLenum &destinationAlpha) {
+    if (state.blendFunc[0] == UNKNOWN) {
+        state.blendFunc[0] = queryInteger(GL_BLEND_SRC_RGB);
+        state.blendFunc[1] = queryInteger(GL_BLEND_DST_RGB);
+        state.blendFunc[2] = queryInteger(GL_BLEND_SRC_ALPHA);
+        state.blendFunc[3] = queryInteger(GL_BLEND_DST_ALPHA);
+    }
+    sourceRgb = state.blendFunc[0];
+    destinationRgb = state.blendFunc[1];
+    sourceAlpha = state.blendFunc[2];
+    destinationAlpha = state.blendFunc[3];
+}
+
+GLenum glstate::getPolygonMode() {
+    if (state.polygonMode == UNKNOWN) {
+        // Front and back; only the front one is kept
+        GLint modes[2];
+        glGetIntegerv(GL_POLYGON_MODE, modes);
+        state.polygonMode = static_cast<GLenum>(modes[0]);
+    }
+    return state.polygonMode;
+}
+
+void glstate::getViewport(GLint (&values)[4]) {
+    if (!state.viewportKnown) {
+        glGetIntegerv(GL_VIEWPORT, state.viewport);
+        state.viewportKnown = true;
+    }
+    for (int i = 0; i < 4; ++i) {
+        values[i] = state.viewport[i];
+    }
+}
+
+void glstate::getScissor(GLint (&values)[4]) {
+    if (!state.scissorKnown) {
+        glGetIntegerv(GL_SCISSOR_BOX, state.scissor);
+        state.scissorKnown = true;
+    }
+    for (int i = 0; i < 4; ++i) {
+        values[i] = state.scissor[i];
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,78 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+
+#include <cstddef>
+
+// ////////////////////////////////////////////////// Namespace: glstate //
+// Shadow copy of the OpenGL state the application changes. Every bind,
+// enable and fixed-function setting goes through these functions, which
+// skip the GL call when the value is already current. Values start out
+// unknown, so the first call always reaches the driver; getters read the
+// shadow copy and only query GL for values not known yet. Only a single
+// context is tracked.
+namespace glstate {
+    struct Statistics {
+        std::size_t issued;
+        std::size_t filtered;
+    };
+
+    // Forget everything, e.g. after code outside this module touched GL
+    void invalidate();
+
+    Statistics getStatistics();
+    void resetStatistics();
+
+    // ------------------------------------------------------ Binding -- //
+    void useProgram(GLuint program);
+    void activeTexture(GLenum unit);
+    // Only GL_TEXTURE_2D is cached, other targets are passed through
+    void bindTexture(GLenum target, GLuint texture);
+    void bindSampler(GLuint unit, GLuint sampler);
+    void bindVertexArray(GLuint vertexArray);
+    // Only GL_ARRAY_BUFFER is cached - the element buffer belongs to the
+    // vertex array, other targets are passed through
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    // ----------------------------------------------- Fixed function -- //
+    // GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST and GL_SCISSOR_TEST are
+    // cached, other capabilities are passed through
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void setEnabled(GLenum capability, bool enabled);
+
+    void blendEquationSeparate(GLenum modeRgb, GLenum modeAlpha);
+    void blendFuncSeparate(GLenum sourceRgb, GLenum destinationRgb,
+                           GLenum sourceAlpha, GLenum destinationAlpha);
+    // Front and back faces together
+    void polygonMode(GLenum mode);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // ----------------------------------------------------- Deletion -- //
+    // Deleting a bound object resets its binding to zero in GL; these
+    // keep the shadow copy in step
+    void deleteTexture(GLuint texture);
+    void deleteVertexArray(GLuint vertexArray);
+    void deleteBuffer(GLuint buffer);
+    void deleteProgram(GLuint program);
+
+    // ------------------------------------------------------ Getters -- //
+    GLuint getProgram();
+    GLenum getActiveTexture();
+    GLuint getTexture2D();
+    GLuint getSampler(GLuint unit);
+    GLuint getVertexArray();
+    GLuint getArrayBuffer();
+    bool isEnabled(GLenum capability);
+    void getBlendEquation(GLenum &modeRgb, GLenum &modeAlpha);
+    void getBlendFunc(GLenum &sourceRgb, GLenum &destinationRgb,
+                      GLenum &sourceAlpha, GLenum &destinationAlpha);
+    GLenum getPolygonMode();
+    void getViewport(GLint (&values)[4]);
+    void getScissor(GLint (&values)[4]);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // GL_STATE_H
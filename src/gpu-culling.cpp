@@ -0,0 +1,88 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "gpu-culling.hpp"
+#include "bounds.hpp"
+#include "gl-state.hpp"
+#include "instance-buffer.hpp"
+
+#include <algorithm>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::value_ptr;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Binding points declared in the compute shader
+    GLuint const INSTANCES_BINDING = 0;
+    GLuint const COMMANDS_BINDING = 1;
+    GLuint const VISIBLE_WORLDS_BINDING = 2;
+}
+
+// /////////////////////////////////////////////////// Class: GpuCulling //
+GLuint const GpuCulling::WORK_GROUP_SIZE;
+
+GpuCulling::GpuCulling()
+        : shader("res/shaders/culling/compute.glsl"),
+          instances(GL_SHADER_STORAGE_BUFFER),
+          instanceCount(0),
+          visibleWorlds(0),
+          visibleCapacity(0) {
+    glGenBuffers(1, &visibleWorlds);
+}
+
+GpuCulling::~GpuCulling() {
+    glstate::deleteBuffer(visibleWorlds);
+}
+
+CullingInstance *GpuCulling::map(std::size_t const count) {
+    instanceCount = count;
+
+    // Every instance may survive, so the output needs the same room
+    if (count > visibleCapacity) {
+        visibleCapacity = std::max(count, 2 * visibleCapacity);
+        glstate::bindBuffer(GL_SHADER_STORAGE_BUFFER, visibleWorlds);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, visibleCapacity * sizeof(mat4),
+                     nullptr, GL_DYNAMIC_COPY);
+    }
+
+    return static_cast<CullingInstance *>(
+            instances.map(count * sizeof(CullingInstance)));
+}
+
+void GpuCulling::unmap() {
+    instances.unmap();
+}
+
+void GpuCulling::cull(mat4 const &viewProjection, StreamBuffer &commands) {
+    if (instanceCount == 0) {
+        return;
+    }
+
+    Frustum const frustum(viewProjection);
+
+    shader.use();
+    shader.uniform4fv("frustumPlanes", 6, value_ptr(frustum.getPlanes()[0]));
+    shader.uniform1ui("instanceCount", static_cast<GLuint>(instanceCount));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCES_BINDING,
+                     instances.getName());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMANDS_BINDING,
+                     commands.getName());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_WORLDS_BINDING,
+                     visibleWorlds);
+
+    GLuint const groupCount = static_cast<GLuint>(
+            (instanceCount + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE);
+    glDispatchCompute(groupCount, 1, 1);
+
+    // The counts are read as draw parameters, the matrices as vertex
+    // attributes
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT
+                    | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void GpuCulling::bind() const {
+    InstanceBuffer::attach(visibleWorlds);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,64 @@
+#ifndef GPU_CULLING_H
+#define GPU_CULLING_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+#include "shader.hpp"
+#include "stream-buffer.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+
+// ///////////////////////////////////////////// Struct: CullingInstance //
+// One instance handed to the GPU, laid out for std430
+struct CullingInstance {
+    glm::mat4 world;
+    // Model-space bounding sphere: center and radius, negative if empty
+    glm::vec4 sphere;
+    // Indirect command drawing the instance, padded to 16 bytes
+    GLuint command;
+    GLuint padding[3];
+};
+
+// /////////////////////////////////////////////////// Class: GpuCulling //
+// Frustum culling in a compute shader. The render queue writes every
+// instance of the frame - world matrix, bounding sphere and the indirect
+// command drawing it - and the commands with their instance counts set
+// to zero. cull() then has each instance inside the frustum append its
+// world matrix to its command's range of the output buffer and bump the
+// command's instance count. The draws read both from GPU memory, so
+// nothing is read back to the CPU.
+class GpuCulling {
+public:
+    GpuCulling();
+    ~GpuCulling();
+
+    GpuCulling(GpuCulling const &) = delete;
+    GpuCulling &operator=(GpuCulling const &) = delete;
+
+    // Write-only room for count instances, valid until unmap()
+    CullingInstance *map(std::size_t count);
+    void unmap();
+
+    // Culls the instances written since the last map(); commands holds
+    // the indirect commands they refer to
+    void cull(glm::mat4 const &viewProjection, StreamBuffer &commands);
+
+    // Attaches the surviving world matrices to the bound vertex array as
+    // instance data
+    void bind() const;
+
+private:
+    static GLuint const WORK_GROUP_SIZE = 64;
+
+    Shader shader;
+    StreamBuffer instances;
+    std::size_t instanceCount;
+
+    // Culled world matrices, written and read only by the GPU
+    GLuint visibleWorlds;
+    std::size_t visibleCapacity;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // GPU_CULLING_H
@@ -0,0 +1,196 @@
+#ifndef HANDLE_POOL_H
+#define HANDLE_POOL_H
+// //////////////////////////////////////////////////////////// Includes //
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// //////////////////////////////////////////////////// Class: PoolHandle //
+// 32-bit reference into a HandlePool: the low bits select a slot, the high
+// bits hold the slot's generation at creation time. Destroying an object
+// bumps its slot's generation, so stale handles fail a single compare.
+template <typename T>
+class PoolHandle {
+public:
+    static std::uint32_t const INDEX_BITS = 22;
+    static std::uint32_t const GENERATION_BITS = 32 - INDEX_BITS;
+    static std::uint32_t const INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static std::uint32_t const GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    PoolHandle() : value(INVALID) {}
+
+    bool isValid() const { return value != INVALID; }
+
+    std::uint32_t getIndex() const { return value & INDEX_MASK; }
+    std::uint32_t getGeneration() const { return value >> INDEX_BITS; }
+
+    bool operator==(PoolHandle const &other) const {
+        return value == other.value;
+    }
+
+    bool operator!=(PoolHandle const &other) const {
+        return value != other.value;
+    }
+
+private:
+    template <typename, std::size_t>
+    friend class HandlePool;
+
+    static std::uint32_t const INVALID = UINT32_MAX;
+
+    PoolHandle(std::uint32_t const index, std::uint32_t const generation)
+            : value((generation << INDEX_BITS) | index) {}
+
+    std::uint32_t value;
+};
+
+template <typename T> std::uint32_t const PoolHandle<T>::INDEX_BITS;
+template <typename T> std::uint32_t const PoolHandle<T>::GENERATION_BITS;
+template <typename T> std::uint32_t const PoolHandle<T>::INDEX_MASK;
+template <typename T> std::uint32_t const PoolHandle<T>::GENERATION_MASK;
+template <typename T> std::uint32_t const PoolHandle<T>::INVALID;
+
+// //////////////////////////////////////////////////// Class: HandlePool //
+// Object pool made of fixed-size blocks. Objects never move once created,
+// freed slots are chained into a free list, so create() and destroy() are
+// O(1) and only touch the heap when a new block is needed.
+template <typename T, std::size_t BLOCK_SIZE = 1024>
+class HandlePool {
+public:
+    using Handle = PoolHandle<T>;
+
+    HandlePool() : slotCount(0), firstFree(NONE), liveCount(0) {}
+
+    HandlePool(HandlePool const &) = delete;
+    HandlePool &operator=(HandlePool const &) = delete;
+
+    ~HandlePool() {
+        clear();
+    }
+
+    template <typename... Args>
+    Handle create(Args &&... args) {
+        if (firstFree == NONE) {
+            addBlock();
+        }
+
+        std::uint32_t const index = firstFree;
+        Slot &slot = getSlot(index);
+
+        new (&slot.storage) T(std::forward<Args>(args)...);
+        firstFree = slot.nextFree;
+        slot.alive = true;
+        ++liveCount;
+
+        return Handle(index, slot.generation);
+    }
+
+    void destroy(Handle const handle) {
+        T *object = get(handle);
+        if (object == nullptr) {
+            return;
+        }
+
+        std::uint32_t const index = handle.getIndex();
+        Slot &slot = getSlot(index);
+
+        object->~T();
+        slot.alive = false;
+        slot.generation = (slot.generation + 1) & Handle::GENERATION_MASK;
+        slot.nextFree = firstFree;
+        firstFree = index;
+        --liveCount;
+    }
+
+    T *get(Handle const handle) {
+        return const_cast<T *>(
+                static_cast<HandlePool const *>(this)->get(handle));
+    }
+
+    T const *get(Handle const handle) const {
+        std::uint32_t const index = handle.getIndex();
+        if (!handle.isValid() || index >= slotCount) {
+            return nullptr;
+        }
+
+        Slot const &slot = getSlot(index);
+        if (!slot.alive || slot.generation != handle.getGeneration()) {
+            return nullptr;
+        }
+        return reinterpret_cast<T const *>(&slot.storage);
+    }
+
+    bool contains(Handle const handle) const {
+        return get(handle) != nullptr;
+    }
+
+    std::size_t size() const {
+        return liveCount;
+    }
+
+    void reserve(std::size_t const count) {
+        while (slotCount < count) {
+            addBlock();
+        }
+    }
+
+    void clear() {
+        for (std::uint32_t index = 0; index < slotCount; ++index) {
+            Slot &slot = getSlot(index);
+            if (slot.alive) {
+                destroy(Handle(index, slot.generation));
+            }
+        }
+    }
+
+private:
+    static std::uint32_t const NONE = UINT32_MAX;
+
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::uint32_t generation;
+        std::uint32_t nextFree;
+        bool alive;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::uint32_t slotCount;
+    std::uint32_t firstFree;
+    std::size_t liveCount;
+
+    Slot &getSlot(std::uint32_t const index) {
+        return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+    Slot const &getSlot(std::uint32_t const index) const {
+        return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+    void addBlock() {
+        // The all-ones index is kept free so no handle equals INVALID
+        if (slotCount + BLOCK_SIZE > Handle::INDEX_MASK) {
+            throw std::bad_alloc();
+        }
+
+        blocks.emplace_back(new Slot[BLOCK_SIZE]);
+        Slot *block = blocks.back().get();
+
+        // Thread the new slots onto the free list in index order
+        for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+            block[i].generation = 0;
+            block[i].alive = false;
+            block[i].nextFree = (i + 1 < BLOCK_SIZE)
+                                ? slotCount + static_cast<std::uint32_t>(i) + 1
+                                : firstFree;
+        }
+        firstFree = slotCount;
+        slotCount += static_cast<std::uint32_t>(BLOCK_SIZE);
+    }
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // HANDLE_POOL_H
@@ -0,0 +1,99 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "image.hpp"
+#include "gl-state.hpp"
+
+#include <exception>
+#include <mutex>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::exception;
+using std::string;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    std::once_flag flipFlag;
+}
+
+// /////////////////////////////////////////////////////// Struct: Image //
+Image::Image()
+        : width(0),
+          height(0),
+          channels(0),
+          pixels(nullptr, stbi_image_free) {
+}
+
+// ////////////////////////////////////////////////////////////// Images //
+Image loadImage(string const &filename) {
+    // The flip is a global setting in stb_image; setting it once keeps
+    // concurrent decodes from racing on it
+    std::call_once(flipFlag, []() {
+        stbi_set_flip_vertically_on_load(true);
+    });
+
+    Image image;
+    image.pixels.reset(stbi_load(filename.c_str(),
+                                 &image.width, &image.height,
+                                 &image.channels, 0));
+
+    if (image.pixels == nullptr) {
+        throw exception("Failed to load texture!");
+    }
+    return image;
+}
+
+GLuint createTexture(Image const &image) {
+    // Generate OpenGL resource
+    GLuint texture;
+    glGenTextures(1, &texture);
+
+    uploadTexture(texture, image);
+
+    // Return texture's ID
+    return texture;
+}
+
+void uploadTexture(GLuint const texture, Image const &image) {
+    // Setup the texture
+    glstate::bindTexture(GL_TEXTURE_2D, texture);
+    {
+        // Set texture parameters
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Pass image to OpenGL
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+                     image.width, image.height, 0,
+                     [&]() -> GLenum {
+                         switch (image.channels) {
+                             case 1:  return GL_RED;
+                             case 3:  return GL_RGB;
+                             case 4:  return GL_RGBA;
+                             default: return GL_RGB;
+                         }
+                     }(),
+                     GL_UNSIGNED_BYTE, image.pixels.get());
+
+        // Generate mipmap for loaded texture
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+}
+
+void uploadPlaceholder(GLuint const texture) {
+    unsigned char const PIXEL[] = {128, 128, 128};
+
+    glstate::bindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0,
+                 GL_RGB, GL_UNSIGNED_BYTE, PIXEL);
+}
+
+GLuint loadTextureFromFile(string const &filename) {
+    return createTexture(loadImage(filename));
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,40 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+
+#include <memory>
+#include <string>
+
+// /////////////////////////////////////////////////////// Struct: Image //
+// Decoded pixels, bottom row first as OpenGL expects them
+struct Image {
+    int width;
+    int height;
+    int channels;
+    std::unique_ptr<unsigned char, void (*)(void *)> pixels;
+
+    Image();
+};
+
+// Decodes an image file; needs no OpenGL context and may run on any
+// thread. Throws when the file cannot be read.
+Image loadImage(std::string const &filename);
+
+// Mipmapped, repeating texture with the image's contents; needs the
+// OpenGL context to be current
+GLuint createTexture(Image const &image);
+
+// Replaces everything in an existing texture, e.g. a placeholder, so
+// whoever holds its name sees the new image
+void uploadTexture(GLuint texture, Image const &image);
+
+// Single grey texel with the same sampling, for a texture whose image is
+// still being decoded
+void uploadPlaceholder(GLuint texture);
+
+// Both of the above on the calling thread
+GLuint loadTextureFromFile(std::string const &filename);
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // IMAGE_H
@@ -0,0 +1,43 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "instance-buffer.hpp"
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::vec4;
+
+// /////////////////////////////////////////////// Class: InstanceBuffer //
+GLuint const InstanceBuffer::WORLD_LOCATION;
+GLuint const InstanceBuffer::BINDING;
+
+InstanceBuffer::InstanceBuffer()
+        : storage(GL_ARRAY_BUFFER) {
+}
+
+void InstanceBuffer::setupVertexArray() {
+    for (GLuint column = 0; column < 4; ++column) {
+        GLuint const location = WORLD_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE,
+                             static_cast<GLuint>(column * sizeof(vec4)));
+        glVertexAttribBinding(location, BINDING);
+    }
+    glVertexBindingDivisor(BINDING, 1);
+}
+
+void InstanceBuffer::bind() const {
+    attach(storage.getName());
+}
+
+void InstanceBuffer::attach(GLuint const buffer) {
+    glBindVertexBuffer(BINDING, buffer, 0, sizeof(mat4));
+}
+
+mat4 *InstanceBuffer::map(std::size_t const count) {
+    return static_cast<mat4 *>(storage.map(count * sizeof(mat4)));
+}
+
+void InstanceBuffer::unmap() {
+    storage.unmap();
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,45 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+#include "stream-buffer.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+
+// /////////////////////////////////////////////// Class: InstanceBuffer //
+// Per-instance data of instanced draws - one world matrix per instance -
+// streamed into a single buffer every frame. Vertex arrays only declare
+// the instance attributes on a fixed binding point, so they do not need
+// to know the buffer; the render queue attaches it when it binds a
+// vertex array and picks each draw's range with the base instance.
+class InstanceBuffer {
+public:
+    // The world matrix takes four consecutive attribute locations
+    static GLuint const WORLD_LOCATION = 2;
+
+    InstanceBuffer();
+
+    // Declares the instance attributes on the bound vertex array
+    static void setupVertexArray();
+
+    // Attaches the buffer to the bound vertex array
+    void bind() const;
+    // Attaches any buffer of world matrices instead
+    static void attach(GLuint buffer);
+
+    // Room for count matrices; the previous contents are discarded.
+    // Write-only until unmap().
+    glm::mat4 *map(std::size_t count);
+    void unmap();
+
+private:
+    // Clear of the binding points used for per-vertex data
+    static GLuint const BINDING = 15;
+
+    StreamBuffer storage;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // INSTANCE_BUFFER_H
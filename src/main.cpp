@@ -1,9 +1,26 @@
 // //////////////////////////////////////////////////////////// Includes //
+#include "allocation-counter.hpp"
+#include "benchmark.hpp"
+#include "frame-arena.hpp"
+#include "geometry-buffer.hpp"
+#include "gl-state.hpp"
+#include "gpu-culling.hpp"
+#include "image.hpp"
+#include "instance-buffer.hpp"
+#include "matrix-kernels.hpp"
 #include "model.hpp"
 #include "opengl-headers.hpp"
+#include "render-queue.hpp"
+#include "resource-manager.hpp"
+#include "scene.hpp"
 #include "shader.hpp"
+#include "sphere-mesh.hpp"
+#include "stream-buffer.hpp"
+#include "task-scheduler.hpp"
+#include "transform.hpp"
 
 #include <chrono>
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <exception>
@@ -11,7 +28,9 @@
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 using sysclock = std::chrono::system_clock;
@@ -40,43 +59,31 @@ using std::unique_ptr;
 using std::shared_ptr;
 using std::vector;
 
-// /////////////////////////////////////////////////// Struct: GraphNode //
-struct GraphNode {
-    mat4 transform;
-    shared_ptr<Renderable> model;
-    GLuint overrideTexture;
-    vector<shared_ptr<GraphNode>> children;
-
-    GraphNode() : overrideTexture(0), model(nullptr) {}
-
-    void render(mat4 const &world = mat4(1.0f)) {
-        mat4 renderTransform = world * transform;
-
-        if (model) {
-            model->shader->use();
-            model->shader->uniformMatrix4fv("transform", value_ptr(renderTransform));
-
-            model->render(model->shader, overrideTexture);
-        }
-
-        for (auto const &child : children) {
-            child->render(renderTransform);
-        }
-    }
-};
-
 // /////////////////////////////////////////////////////////// Constants //
 int const WINDOW_WIDTH = 1589;
 int const WINDOW_HEIGHT = 982;
 char const *WINDOW_TITLE = "Tomasz Witczak 216920 - Zadanie 3";
 
+std::size_t const FRAME_ARENA_CAPACITY = 1024 * 1024;
+
+std::size_t const BENCHMARK_NODE_COUNT = 100000;
+std::size_t const BENCHMARK_MATRIX_COUNT = 100000;
+std::size_t const BENCHMARK_TREE_MIN_OBJECTS = 10000;
+std::size_t const BENCHMARK_TREE_MAX_OBJECTS = 1000000;
+std::size_t const BENCHMARK_SPHERE_COUNT = 1000;
+
+// Crowd of amplifier copies drawn with instancing, CROWD_SIDE^2 of them
+int const CROWD_SIDE = 100;
+float const CROWD_SPACING = 0.06f;
+
 // /////////////////////////////////////////////////////////// Variables //
 // ----------------------------------------------------------- Window -- //
 GLFWwindow *window = nullptr;
 
 // ---------------------------------------------------------- Shaders -- //
 shared_ptr<Shader> modelShader,
-                   sphereShader;
+                   impostorShader,
+                   tessellationShader;
 
 // --------------------------------------------------------- Textures -- //
 GLuint plywoodTexture = 0,
@@ -86,129 +93,185 @@ GLuint plywoodTexture = 0,
 vec3 cameraPos(0.6f, 1.7f, 2.5f);
 
 // ------------------------------------------------------ Scene graph -- //
-GraphNode scene;
+RenderablePool renderables;
+Scene scene(renderables);
+Scene::Node gibson, ball, amp, otherSystem, jupiter;
+vector<Scene::Node> crowd;
 
-// --------------------------------------------------- Rendering mode -- //
-bool wireframeMode = false;
+// ------------------------------------------------------------ Tasks -- //
+unique_ptr<TaskScheduler> taskScheduler;
 
-// ----------------------------------------------------------- Models -- //
-shared_ptr<Renderable> sphere, amplifier, guitar, orbit;
+// ------------------------------------------------------- Benchmarks -- //
+vector<BenchmarkResult> benchmarkResults;
 
-// //////////////////////////////////////////////////////////// Textures //
-GLuint loadTextureFromFile(string const &filename) {
-    // Generate OpenGL resource
-    GLuint texture;
-    glGenTextures(1, &texture);
+// ------------------------------------------------- Per-frame memory -- //
+FrameArena frameArena(FRAME_ARENA_CAPACITY);
+std::size_t allocationsPerFrame = 0;
 
-    // Setup the texture
-    glBindTexture(GL_TEXTURE_2D, texture);
-    {
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Load texture from file
-        stbi_set_flip_vertically_on_load(true);
-
-        int imageWidth, imageHeight, imageNumberOfChannels;
-        unsigned char *textureData = stbi_load(
-            filename.c_str(),
-            &imageWidth, &imageHeight,
-            &imageNumberOfChannels, 0);
-
-        if (textureData == nullptr) {
-            throw exception("Failed to load texture!");
-        }
+// ------------------------------------------------------- Instancing -- //
+unique_ptr<InstanceBuffer> instanceBuffer;
 
-        // Pass image to OpenGL
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-                     imageWidth, imageHeight, 0,
-                     [&]() -> GLenum {
-                         switch (imageNumberOfChannels) {
-                             case 1:  return GL_RED;
-                             case 3:  return GL_RGB;
-                             case 4:  return GL_RGBA;
-                             default: return GL_RGB;
-                         }
-                     }(),
-                     GL_UNSIGNED_BYTE, textureData);
-
-        // Generate mipmap for loaded texture
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // After loading into OpenGL - release the raw resource
-        stbi_image_free(textureData);
-    }
+// ---------------------------------------------------------- Geometry -- //
+unique_ptr<GeometryBuffer> geometryBuffer;
+unique_ptr<StreamBuffer> drawCommandBuffer;
 
-    // Return texture's ID
-    return texture;
-}
+// -------------------------------------------------------- Resources -- //
+unique_ptr<ResourceManager> resources;
+
+// ---------------------------------------------------------- Culling -- //
+unique_ptr<GpuCulling> gpuCulling;
+bool gpuCullingEnabled = false;
+std::size_t visibleNodeCount = 0;
+RenderStatistics renderStatistics = {0, 0, 0, 0, 0, 0};
+glstate::Statistics glStatistics = {0, 0};
+
+// ---------------------------------------------------------- Picking -- //
+Scene::Node pickedNode;
+bool mouseButtonWasPressed = false;
+
+// --------------------------------------------------- Rendering mode -- //
+bool wireframeMode = false;
+bool levelOfDetail = true;
+
+// ----------------------------------------------------------- Models -- //
+RenderableHandle sphere, amplifier, guitar, orbit;
 
 // /////////////////////////////////////////////////////// Class: Sphere //
 class Sphere : public Renderable {
 public:
     static constexpr int SUBDIVISION_LEVEL_MIN = 1;
-    static constexpr int SUBDIVISION_LEVEL_MAX = 7;
+    static constexpr int SUBDIVISION_LEVEL_MAX = 32;
+
+    enum Method {
+        MESH,
+        // Ray-cast impostors cost the same at every subdivision level
+        IMPOSTOR,
+        // Patches subdivided on the GPU by their size on screen; the
+        // subdivision level is not used
+        TESSELLATION
+    };
 
 private:
-    GLuint vao, vbo;
+    GLuint vao;
+    // One mesh per subdivision level, from SUBDIVISION_LEVEL_MIN up
+    vector<GeometryRange> meshes;
+    // A single point, expanded to a quad by the impostor shader
+    GeometryRange point;
+    GeometryRange patches;
+    shared_ptr<Shader> impostorShader,
+                       tessellationShader;
     GLuint texture;
 
-    vec3 const point {0.0f, 0.0f, 0.0f};
-
 public:
     static int subdivisionLevel;
+    static int method;
+
+    Sphere(GeometryBuffer &geometryBuffer,
+           shared_ptr<Shader> const &impostorShader,
+           shared_ptr<Shader> const &tessellationShader,
+           GLuint const texture)
+            : impostorShader(impostorShader),
+              tessellationShader(tessellationShader),
+              texture(texture) {
+        // Every level is built once; switching levels only picks another
+        // range of the geometry buffer
+        vao = geometryBuffer.getVertexArray();
+        point = geometryBuffer.add({{vec3(0.0f), glm::vec2(0.0f)}}, {0});
+
+        vector<Vertex> vertices;
+        vector<unsigned int> indices;
+        for (int level = SUBDIVISION_LEVEL_MIN;
+             level <= SUBDIVISION_LEVEL_MAX; ++level) {
+            generateSphereMesh(level, vertices, indices);
+            meshes.push_back(geometryBuffer.add(vertices, indices));
+        }
 
-    Sphere() {
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
-
-        glBindVertexArray(vao);
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex), &point,
-                        GL_STATIC_DRAW);
-
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                        sizeof(vec3), nullptr);
-
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
-        texture = loadTextureFromFile("res/textures/jupiter.jpg");
-    }
+        generateSpherePatches(SPHERE_PATCH_SUBDIVISION_LEVEL,
+                              vertices, indices);
+        patches = geometryBuffer.add(vertices, indices);
 
-    ~Sphere() {
-        glDeleteBuffers(1, &vbo);
-        glDeleteVertexArrays(1, &vao);
+        bounds = BoundingBox(vec3(-1.0f), vec3(1.0f));
+        boundingSphere = BoundingSphere(vec3(0.0f), 1.0f);
     }
 
-    void render(shared_ptr<Shader> shader,
-                GLuint const overrideTexture) const {
-        shader->use();
-
-        sphereShader->uniform1i("subdivisionLevelHorizontal",
-                subdivisionLevel + 2);
-        sphereShader->uniform1i("subdivisionLevelVertical",
-                subdivisionLevel + 1);
-
-        sphereShader->uniform1i("texture0", 0);
+    // Each detail level halves the subdivision level set in the UI
+    void enqueue(RenderQueue &queue, mat4 const &world,
+                 GLuint const overrideTexture, int const level) const {
+        int const subdivision = std::max(subdivisionLevel >> level,
+                                         SUBDIVISION_LEVEL_MIN);
+
+        DrawItem item;
+        item.renderable = this;
+        item.shader = shader.get();
+        item.world = &world;
+        item.boundingSphere = &boundingSphere;
+        item.texture = overrideTexture != 0 ? overrideTexture : texture;
+        item.vao = vao;
+        switch (method) {
+            case IMPOSTOR:
+                item.shader = impostorShader.get();
+                item.mode = GL_POINTS;
+                item.geometry = point;
+                break;
+            case TESSELLATION:
+                item.shader = tessellationShader.get();
+                item.mode = GL_PATCHES;
+                item.geometry = patches;
+                break;
+            default:
+                item.mode = GL_TRIANGLES;
+                item.geometry = meshes[subdivision - SUBDIVISION_LEVEL_MIN];
+                break;
+        }
 
-        glEnable(GL_DEPTH_TEST);
+        queue.add(item);
+    }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, overrideTexture != 0 ? overrideTexture : texture);
+    // Tessellation levels are picked in pixels
+    void setupShader(Shader &shader) const {
+        if (&shader != tessellationShader.get()) {
+            return;
+        }
 
-        glBindVertexArray(vao);
-            glDrawArrays(GL_POINTS, 0, 1);
-        glBindVertexArray(0);
+        GLint viewport[4];
+        glstate::getViewport(viewport);
+        shader.uniform1f("viewportHeight", static_cast<float>(viewport[3]));
+        glPatchParameteri(GL_PATCH_VERTICES, 4);
     }
 };
 int Sphere::subdivisionLevel = Sphere::SUBDIVISION_LEVEL_MAX;
+int Sphere::method = Sphere::MESH;
 
 
+// /////////////////////////////////////////////////////////////// Crowd //
+void toggleCrowd() {
+    if (!crowd.empty()) {
+        for (Scene::Node const node : crowd) {
+            scene.removeNode(node);
+        }
+        crowd.clear();
+        return;
+    }
+
+    // A flat grid under the rest of the scene; every copy shares the
+    // amplifier's meshes, so each mesh is one instanced draw
+    float const offset = 0.5f * (CROWD_SIDE - 1) * CROWD_SPACING;
+    crowd.reserve(CROWD_SIDE * CROWD_SIDE);
+    for (int row = 0; row < CROWD_SIDE; ++row) {
+        for (int column = 0; column < CROWD_SIDE; ++column) {
+            Scene::Node const node = scene.addNode(scene.getRoot(),
+                                                   amplifier);
+            scene.setTransform(node,
+                    Transform::fromTranslation(vec3(
+                            column * CROWD_SPACING - offset,
+                            -0.5f,
+                            row * CROWD_SPACING - offset)) *
+                    Transform::fromScale(vec3(0.002f)));
+            crowd.push_back(node);
+        }
+    }
+}
+
 // ////////////////////////////////////////////////////// User interface //
 void setupDearImGui() {
     constexpr char const *GLSL_VERSION = "#version 430";
@@ -235,17 +298,119 @@ void prepareUserInterfaceWindow() {
         if (ImGui::Button("Tryb siatki")) {
             wireframeMode = !wireframeMode;
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Tlum wzmacniaczy (10k)")) {
+            toggleCrowd();
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Culling na GPU", &gpuCullingEnabled);
+        if (ImGui::Checkbox("Poziomy szczegolowosci", &levelOfDetail)) {
+            scene.setLevelOfDetail(levelOfDetail);
+        }
+        ImGui::SameLine();
+        ImGui::Text("Trojkaty: %u",
+                    (unsigned)renderStatistics.triangles);
+        ImGui::Text("Kula:");
+        ImGui::SameLine();
+        ImGui::RadioButton("siatka", &Sphere::method, Sphere::MESH);
+        ImGui::SameLine();
+        ImGui::RadioButton("impostor", &Sphere::method, Sphere::IMPOSTOR);
+        ImGui::SameLine();
+        ImGui::RadioButton("teselacja", &Sphere::method,
+                           Sphere::TESSELLATION);
         ImGui::SliderFloat("Kamera (x)", &cameraPos.x, 0.0f, 4.0f);
         ImGui::SliderFloat("Kamera (y)", &cameraPos.y, 0.0f, 4.0f);
         ImGui::SliderFloat("Kamera (z)", &cameraPos.z, 0.5f, 4.0f);
+        ImGui::Text("Alokacje na klatke: %u, pamiec klatki: %u / %u B",
+                    (unsigned)allocationsPerFrame,
+                    (unsigned)frameArena.getPeak(),
+                    (unsigned)frameArena.getCapacity());
+        // With GPU culling the CPU never learns what was visible
+        ImGui::Text(gpuCullingEnabled
+                            ? "Obiekty: %u, wywolania rysowania: %u (%u)"
+                            : "Widoczne obiekty: %u, "
+                              "wywolania rysowania: %u (%u)",
+                    (unsigned)visibleNodeCount,
+                    (unsigned)renderStatistics.drawCalls,
+                    (unsigned)renderStatistics.drawCommands);
+        ImGui::Text("Zmiany stanu: programy %u, tekstury %u, VAO %u",
+                    (unsigned)renderStatistics.programChanges,
+                    (unsigned)renderStatistics.textureChanges,
+                    (unsigned)renderStatistics.vertexArrayChanges);
+        ImGui::Text("Wywolania GL: wykonane %u, pominiete %u",
+                    (unsigned)glStatistics.issued,
+                    (unsigned)glStatistics.filtered);
+        if (scene.contains(pickedNode)) {
+            vec3 const center = scene.getWorldBounds(pickedNode).getCenter();
+            ImGui::Text("Wskazany obiekt: (%.2f, %.2f, %.2f)",
+                        center.x, center.y, center.z);
+        } else {
+            ImGui::Text("Wskazany obiekt: brak");
+        }
+        ImGui::Text("Wczytywane zasoby: %u",
+                    (unsigned)resources->getPendingCount());
+        TextureCache::Statistics const textureStatistics =
+                resources->getTextureStatistics();
+        ImGui::Text("Tekstury: %u (%u KB), trafienia %u, chybienia %u",
+                    (unsigned)textureStatistics.textureCount,
+                    (unsigned)(textureStatistics.residentBytes / 1024),
+                    (unsigned)textureStatistics.hits,
+                    (unsigned)textureStatistics.misses);
 
         ImGui::SetWindowPos(ImVec2(0.0f, 0.0f));
-        ImGui::SetWindowSize(ImVec2(400.0f, 150.0f));
+        ImGui::SetWindowSize(ImVec2(400.0f, 344.0f));
+    }
+    ImGui::End();
+    ImGui::Begin("Testy wydajnosci");
+    {
+        if (ImGui::Button("Harmonogram zadan (100k wezlow)")) {
+            benchmarkResults = benchmarkTaskScheduler(
+                    BENCHMARK_NODE_COUNT,
+                    std::max(std::thread::hardware_concurrency(), 1u));
+        }
+        if (ImGui::Button("Mnozenie macierzy (100k)")) {
+            benchmarkResults = benchmarkMatrixKernels(BENCHMARK_MATRIX_COUNT);
+        }
+        // Builds trees of up to a million objects on this thread; the
+        // window stops responding until it is done
+        if (ImGui::Button("Drzewo AABB (10k - 1M obiektow, blokuje)")) {
+            benchmarkResults = benchmarkAabbTree(BENCHMARK_TREE_MIN_OBJECTS,
+                                                 BENCHMARK_TREE_MAX_OBJECTS);
+        }
+        if (ImGui::Button("Kula: wszystkie metody (1k)")) {
+            benchmarkResults = benchmarkSphereRendering(
+                    BENCHMARK_SPHERE_COUNT, Sphere::SUBDIVISION_LEVEL_MAX);
+        }
+        // Decoding runs on the workers, uploading on this thread
+        if (ImGui::Button("Tekstury: dekodowanie i wysylanie")) {
+            benchmarkResults.clear();
+            for (auto const &timing : resources->getTextureTimings()) {
+                string const name =
+                        timing.path.substr(timing.path.rfind('/') + 1);
+                benchmarkResults.push_back({name + " - dekodowanie",
+                                            timing.decodeMilliseconds});
+                benchmarkResults.push_back({name + " - wysylanie",
+                                            timing.uploadMilliseconds});
+            }
+        }
+        ImGui::Text("Jadro macierzy: %s", getMatrixKernel().name);
+        for (auto const &result : benchmarkResults) {
+            ImGui::Text("%s: %.3f ms", result.label.c_str(),
+                        result.milliseconds);
+        }
+
+        ImGui::SetWindowPos(ImVec2(0.0f, 344.0f), ImGuiCond_FirstUseEver);
+        ImGui::SetWindowSize(ImVec2(400.0f, 400.0f), ImGuiCond_FirstUseEver);
     }
     ImGui::End();
     ImGui::Render();
 }
 
+// /////////////////////////////////////////////////////////////// Tasks //
+void setupTaskScheduler() {
+    taskScheduler = make_unique<TaskScheduler>();
+}
+
 // //////////////////////////////////////////////////////// Setup OpenGL //
 void setupGLFW() {
     glfwSetErrorCallback(
@@ -296,97 +461,83 @@ void initializeOpenGLLoader() {
     }
 }
 
-void setupSceneGraph(float const deltaTime, float const displayWidth, float const displayHeight) {
-    static mat4 const identity = mat4(1.0f);
+void setupSceneGraph() {
+    // Scene - parents have to be added before their children
+    Scene::Node const ball2 = scene.addNode(scene.getRoot(), sphere);
+    scene.setTransform(ball2,
+            Transform::fromTranslation(vec3(0.75f, 0.0f, 0.75f)) *
+            Transform::fromRotation(glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromScale(vec3(0.6f)));
+
+    Scene::Node const lonelyBlue = scene.addNode(scene.getRoot(), amplifier);
+    scene.setTransform(lonelyBlue,
+            Transform::fromTranslation(vec3(1.25f, 0.5f, -0.5f)) *
+            Transform::fromScale(vec3(0.0125f)));
+
+    Scene::Node const notLonelyBlue = scene.addNode(scene.getRoot(), guitar);
+    scene.setTransform(notLonelyBlue,
+            Transform::fromTranslation(vec3(-1.0f, 0.0f, 0.0f)) *
+            Transform::fromRotation(glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromScale(vec3(0.1f)));
+
+    Scene::Node const firstOrbit = scene.addNode(notLonelyBlue, orbit,
+                                                 metalTexture);
+    scene.setTransform(firstOrbit,
+            Transform::fromRotation(glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromScale(vec3(10.0f)));
+
+    jupiter = scene.addNode(firstOrbit, sphere, metalTexture);
+
+    otherSystem = scene.addNode(firstOrbit);
+
+    Scene::Node const secondOrbit = scene.addNode(otherSystem, orbit,
+                                                  plywoodTexture);
+    scene.setTransform(secondOrbit,
+            Transform::fromRotation(glm::radians(45.0f), vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromScale(vec3(0.5f)));
+
+    ball = scene.addNode(secondOrbit, sphere, plywoodTexture);
+    gibson = scene.addNode(secondOrbit, guitar, plywoodTexture);
+
+    amp = scene.addNode(otherSystem, amplifier, metalTexture);
+}
+
+void updateSceneGraph(float const deltaTime) {
     static float angle = 0.0f;
     angle += glm::radians(45.0f) * deltaTime;
 
-    // Scene elements
-    shared_ptr<GraphNode> gibson = make_shared<GraphNode>();
-    gibson->transform =
-            glm::rotate(identity, angle, vec3(0.0f, 1.0f, 0.0f)) *
-            glm::translate(identity, vec3(-1.0f, 0.0f, 0.0f)) *
-            glm::rotate(identity, -angle, vec3(0.5f, 0.25f, 0.0f)) *
-            glm::scale(identity, vec3(0.1f));
-    gibson->model = guitar;
-    gibson->overrideTexture = plywoodTexture;
-
-    shared_ptr<GraphNode> ball = make_shared<GraphNode>();
-    ball->transform =
-            glm::rotate(identity, angle, vec3(0.0f, 1.0f, 0.0f)) *
-            glm::translate(identity, vec3(1.0f, 0.0f, 0.0f)) *
-            glm::rotate(identity, 2.0f * angle, vec3(0.0f, 0.0f, 1.0f)) *
-            glm::scale(identity, vec3(0.1f));
-    ball->model = sphere;
-    ball->overrideTexture = plywoodTexture;
-
-    shared_ptr<GraphNode> secondOrbit = make_shared<GraphNode>();
-    secondOrbit->transform =
-            glm::rotate(identity, glm::radians(45.0f), vec3(1.0f, 0.0f, 0.0f)) *
-            glm::scale(identity, vec3(0.5f));
-    secondOrbit->model = orbit;
-    secondOrbit->overrideTexture = plywoodTexture;
-    secondOrbit->children.clear();
-    secondOrbit->children.push_back(ball);
-    secondOrbit->children.push_back(gibson);
-
-    shared_ptr<GraphNode> amp = make_shared<GraphNode>();
-    amp->transform =
-            glm::rotate(identity, 1.5f * angle, vec3(1.0f, 0.0f, 1.0f)) *
-            glm::scale(identity, vec3(0.004f));
-    amp->model = amplifier;
-    amp->overrideTexture = metalTexture;
-
-    shared_ptr<GraphNode> otherSystem = make_shared<GraphNode>();
-    otherSystem->transform =
-            glm::rotate(identity, angle, vec3(0.0f, 1.0f, 0.0f)) *
-            glm::translate(identity, vec3(-1.0f, 0.0f, 0.0f));
-    otherSystem->children.clear();
-    otherSystem->children.push_back(secondOrbit);
-    otherSystem->children.push_back(amp);
-
-    shared_ptr<GraphNode> jupiter = make_shared<GraphNode>();
-    jupiter->transform =
-            glm::rotate(identity, angle, vec3(0.0f, 1.0f, 0.0f)) *
-            glm::translate(identity, vec3(1.0f, 0.0f, 0.0f)) *
-            glm::rotate(identity, -angle, vec3(0.0f, 1.0f, 1.0f)) *
-            glm::scale(identity, vec3(0.3f));
-    jupiter->model = sphere;
-    jupiter->overrideTexture = metalTexture;
-
-    shared_ptr<GraphNode> firstOrbit = make_shared<GraphNode>();
-    firstOrbit->transform =
-            glm::rotate(identity, glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
-            glm::scale(identity, vec3(10.0f));
-    firstOrbit->model = orbit;
-    firstOrbit->overrideTexture = metalTexture;
-    firstOrbit->children.clear();
-    firstOrbit->children.push_back(jupiter);
-    firstOrbit->children.push_back(otherSystem);
-
-    shared_ptr<GraphNode> lonelyBlue = make_shared<GraphNode>();
-    lonelyBlue->transform =
-            glm::translate(identity, vec3(1.25f, 0.5f, -0.5f)) *
-            glm::scale(identity, vec3(0.0125f));
-    lonelyBlue->model = amplifier;
-
-    shared_ptr<GraphNode> ball2 = make_shared<GraphNode>();
-    ball2->transform =
-            glm::translate(identity, vec3(0.75f, 0.0f, 0.75f)) *
-            glm::rotate(identity, glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
-            glm::scale(identity, vec3(0.6f));
-    ball2->model = sphere;
-
-    shared_ptr<GraphNode> notLonelyBlue = make_shared<GraphNode>();
-    notLonelyBlue->transform =
-            glm::translate(identity, vec3(-1.0f, 0.0f, 0.0f)) *
-            glm::rotate(identity, glm::radians(90.0f), vec3(1.0f, 0.0f, 0.0f)) *
-            glm::scale(identity, vec3(0.1f));
-    notLonelyBlue->model = guitar;
-    notLonelyBlue->children.clear();
-    notLonelyBlue->children.push_back(firstOrbit);
-
-    // Scene
+    // Only the animated nodes get new local transforms, the rest of the
+    // graph keeps its cached world transforms
+    scene.setTransform(gibson,
+            Transform::fromRotation(angle, vec3(0.0f, 1.0f, 0.0f)) *
+            Transform::fromTranslation(vec3(-1.0f, 0.0f, 0.0f)) *
+            Transform::fromRotation(-angle, vec3(0.5f, 0.25f, 0.0f)) *
+            Transform::fromScale(vec3(0.1f)));
+
+    scene.setTransform(ball,
+            Transform::fromRotation(angle, vec3(0.0f, 1.0f, 0.0f)) *
+            Transform::fromTranslation(vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromRotation(2.0f * angle, vec3(0.0f, 0.0f, 1.0f)) *
+            Transform::fromScale(vec3(0.1f)));
+
+    scene.setTransform(amp,
+            Transform::fromRotation(1.5f * angle, vec3(1.0f, 0.0f, 1.0f)) *
+            Transform::fromScale(vec3(0.004f)));
+
+    scene.setTransform(otherSystem,
+            Transform::fromRotation(angle, vec3(0.0f, 1.0f, 0.0f)) *
+            Transform::fromTranslation(vec3(-1.0f, 0.0f, 0.0f)));
+
+    scene.setTransform(jupiter,
+            Transform::fromRotation(angle, vec3(0.0f, 1.0f, 0.0f)) *
+            Transform::fromTranslation(vec3(1.0f, 0.0f, 0.0f)) *
+            Transform::fromRotation(-angle, vec3(0.0f, 1.0f, 1.0f)) *
+            Transform::fromScale(vec3(0.3f)));
+
+    scene.update(taskScheduler.get());
+}
+
+mat4 computeViewProjection(float const displayWidth, float const displayHeight) {
     mat4 const projection = perspective(radians(60.0f),
                                         ((float)displayWidth) / ((float)displayHeight),
                                         0.01f, 100.0f);
@@ -395,11 +546,45 @@ void setupSceneGraph(float const deltaTime, float const displayWidth, float cons
                              vec3(0.0f, 0.0f, 0.0f),
                              vec3(0.0f, 1.0f, 0.0f));
 
-    scene.transform = projection * view;
-    scene.children.clear();
-    scene.children.push_back(ball2);
-    scene.children.push_back(lonelyBlue);
-    scene.children.push_back(notLonelyBlue);
+    return projection * view;
+}
+
+void pickObjectUnderCursor(mat4 const &viewProjection) {
+    // React to the press only, and not when the click belongs to the UI
+    bool const pressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT)
+                         == GLFW_PRESS;
+    bool const clicked = pressed && !mouseButtonWasPressed &&
+                         !ImGui::GetIO().WantCaptureMouse;
+    mouseButtonWasPressed = pressed;
+    if (!clicked) {
+        return;
+    }
+
+    double cursorX, cursorY;
+    int windowWidth, windowHeight;
+    glfwGetCursorPos(window, &cursorX, &cursorY);
+    glfwGetWindowSize(window, &windowWidth, &windowHeight);
+
+    // Unproject the cursor onto the near and far planes
+    float const x = 2.0f * (float)cursorX / windowWidth - 1.0f;
+    float const y = 1.0f - 2.0f * (float)cursorY / windowHeight;
+
+    mat4 const inverseViewProjection = glm::inverse(viewProjection);
+    glm::vec4 const nearPoint =
+            inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 const farPoint =
+            inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+
+    vec3 const origin = vec3(nearPoint) / nearPoint.w;
+    vec3 const target = vec3(farPoint) / farPoint.w;
+
+    pickedNode = scene.pick(origin, glm::normalize(target - origin));
+}
+
+RenderableHandle addRenderable(unique_ptr<Renderable> renderable,
+                               shared_ptr<Shader> const &shader) {
+    renderable->shader = shader;
+    return renderables.create(std::move(renderable));
 }
 
 void setupOpenGL() {
@@ -407,27 +592,49 @@ void setupOpenGL() {
     createWindow();
     initializeOpenGLLoader();
 
-    plywoodTexture = loadTextureFromFile("res/textures/plywood.jpg");
-    metalTexture = loadTextureFromFile("res/textures/metal.jpg");
-
-    amplifier = make_shared<Model>("res/models/orange-th30.obj");
-    guitar = make_shared<Model>("res/models/gibson-es335.obj");
-    orbit = make_shared<Model>("res/models/orbit.obj");
+    instanceBuffer = make_unique<InstanceBuffer>();
+    geometryBuffer = make_unique<GeometryBuffer>();
+    drawCommandBuffer = make_unique<StreamBuffer>(GL_DRAW_INDIRECT_BUFFER);
+    gpuCulling = make_unique<GpuCulling>();
 
     modelShader = make_shared<Shader>("res/shaders/model/vertex.glsl",
                                       "res/shaders/model/geometry.glsl",
                                       "res/shaders/model/fragment.glsl");
 
-    sphereShader = make_shared<Shader>("res/shaders/sphere/vertex.glsl",
-                                       "res/shaders/sphere/geometry.glsl",
-                                       "res/shaders/sphere/fragment.glsl");
-
-    sphere = make_shared<Sphere>();
-
-    amplifier->shader = modelShader;
-    guitar->shader = modelShader;
-    orbit->shader = modelShader;
-    sphere->shader = sphereShader;
+    impostorShader = make_shared<Shader>(
+            "res/shaders/sphere/vertex.glsl",
+            "res/shaders/impostor/geometry.glsl",
+            "res/shaders/impostor/fragment.glsl");
+
+    tessellationShader = make_shared<Shader>(
+            "res/shaders/tessellation/vertex.glsl",
+            "res/shaders/tessellation/control.glsl",
+            "res/shaders/tessellation/evaluation.glsl",
+            "res/shaders/model/fragment.glsl");
+
+    // Everything below is usable at once and draws placeholders until
+    // the resource manager swaps the loaded data in
+    resources = make_unique<ResourceManager>(*taskScheduler, renderables,
+                                             scene, *geometryBuffer);
+
+    plywoodTexture = resources->loadTexture("res/textures/plywood.jpg");
+    metalTexture = resources->loadTexture("res/textures/metal.jpg");
+
+    amplifier = resources->loadModel("res/models/orange-th30.obj",
+                                     modelShader);
+    guitar = resources->loadModel("res/models/gibson-es335.obj",
+                                  modelShader);
+    orbit = resources->loadModel("res/models/orbit.obj", modelShader);
+
+    GLuint const jupiterTexture =
+            resources->loadTexture("res/textures/jupiter.jpg");
+    sphere = addRenderable(make_unique<Sphere>(*geometryBuffer,
+                                               impostorShader,
+                                               tessellationShader,
+                                               jupiterTexture),
+                           modelShader);
+
+    setupSceneGraph();
 
     setupDearImGui();
 }
@@ -438,14 +645,20 @@ void cleanUp() {
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
-    sphere = nullptr;
+    scene.clear();
+    renderables.clear();
+    resources = nullptr;
 
-    sphereShader = nullptr;
+    tessellationShader = nullptr;
+    impostorShader = nullptr;
     modelShader = nullptr;
 
-    orbit = nullptr;
-    guitar = nullptr;
-    amplifier = nullptr;
+    gpuCulling = nullptr;
+    drawCommandBuffer = nullptr;
+    geometryBuffer = nullptr;
+    instanceBuffer = nullptr;
+
+    taskScheduler = nullptr;
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -460,6 +673,11 @@ void performMainLoop() {
         sec const deltaTime = startTime - previousStartTime;
         previousStartTime = startTime;
 
+        // ----------------------------------------- Per-frame memory -- //
+        std::size_t const allocationsAtFrameStart = getAllocationCount();
+        frameArena.reset();
+        glstate::resetStatistics();
+
         // --------------------------------------------------- Events -- //
         glfwPollEvents();
 
@@ -470,17 +688,37 @@ void performMainLoop() {
                                &displayHeight);
 
         // ------------------------------------------- Clear viewport -- //
-        glViewport(0, 0, displayWidth, displayHeight);
+        glstate::viewport(0, 0, displayWidth, displayHeight);
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // --------------------------------------- Set rendering mode -- //
-        glEnable(GL_DEPTH_TEST);
-        glPolygonMode(GL_FRONT_AND_BACK, wireframeMode ? GL_LINE : GL_FILL);
+        glstate::enable(GL_DEPTH_TEST);
+        glstate::polygonMode(wireframeMode ? GL_LINE : GL_FILL);
 
         // --------------------------------------------- Render scene -- //
-        setupSceneGraph(deltaTime.count(), displayWidth, displayHeight);
-        scene.render();
+        mat4 const viewProjection = computeViewProjection(displayWidth,
+                                                          displayHeight);
+        resources->update();
+        updateSceneGraph(deltaTime.count());
+
+        RenderQueue renderQueue(frameArena);
+        if (gpuCullingEnabled) {
+            visibleNodeCount = scene.enqueueAll(viewProjection,
+                                                renderQueue);
+            renderStatistics = renderQueue.submit(viewProjection,
+                                                  *instanceBuffer,
+                                                  *drawCommandBuffer,
+                                                  gpuCulling.get());
+        } else {
+            visibleNodeCount = scene.enqueue(viewProjection, renderQueue);
+            renderStatistics = renderQueue.submit(viewProjection,
+                                                  *instanceBuffer,
+                                                  *drawCommandBuffer);
+        }
+
+        // -------------------------------------------------- Picking -- //
+        pickObjectUnderCursor(viewProjection);
 
         // ------------------------------------------------------- UI -- //
         prepareUserInterfaceWindow();
@@ -490,6 +728,9 @@ void performMainLoop() {
         // -------------------------------------------- Update screen -- //
         glfwMakeContextCurrent(window);
         glfwSwapBuffers(window);
+
+        allocationsPerFrame = getAllocationCount() - allocationsAtFrameStart;
+        glStatistics = glstate::getStatistics();
     }
 }
 
@@ -497,6 +738,7 @@ void performMainLoop() {
 // //////////////////////////////////////////////////////////////// Main //
 int main() {
     try {
+        setupTaskScheduler();
         setupOpenGL();
         performMainLoop();
         cleanUp();
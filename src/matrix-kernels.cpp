@@ -0,0 +1,327 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "matrix-kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    defined(__i386__) || defined(_M_IX86)
+#define MATRIX_KERNELS_X86
+#endif
+
+#if defined(MATRIX_KERNELS_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+
+using std::size_t;
+using std::vector;
+
+// ///////////////////////////////////////////////////////// Target flags //
+// GCC and Clang only emit vector instructions in functions built for them;
+// MSVC accepts the intrinsics anywhere
+#if defined(MATRIX_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+// ///////////////////////////////////////////////////////////// Kernels //
+namespace {
+    // Column-major, as glm stores it: column j of the product is the lhs
+    // columns weighted by the elements of rhs column j
+    void multiplyScalar(mat4 const *const *lhs, mat4 const *const *rhs,
+                        mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+            float r[16];
+
+            for (int column = 0; column < 4; ++column) {
+                float const b0 = b[column * 4 + 0],
+                            b1 = b[column * 4 + 1],
+                            b2 = b[column * 4 + 2],
+                            b3 = b[column * 4 + 3];
+
+                for (int row = 0; row < 4; ++row) {
+                    r[column * 4 + row] = a[row] * b0 +
+                                          a[4 + row] * b1 +
+                                          a[8 + row] * b2 +
+                                          a[12 + row] * b3;
+                }
+            }
+
+            float *out = &(*result[i])[0][0];
+            for (int j = 0; j < 16; ++j) {
+                out[j] = r[j];
+            }
+        }
+    }
+
+    // The first three lhs columns end in 0 and the last in 1, so the
+    // bottom row comes out right without its own terms; the last lhs
+    // column is only added to the last result column
+    void multiplyAffineScalar(mat4 const *const *lhs, mat4 const *const *rhs,
+                              mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+            float r[16];
+
+            for (int column = 0; column < 4; ++column) {
+                float const b0 = b[column * 4 + 0],
+                            b1 = b[column * 4 + 1],
+                            b2 = b[column * 4 + 2];
+
+                for (int row = 0; row < 4; ++row) {
+                    r[column * 4 + row] = a[row] * b0 +
+                                          a[4 + row] * b1 +
+                                          a[8 + row] * b2;
+                }
+            }
+            for (int row = 0; row < 4; ++row) {
+                r[12 + row] += a[12 + row];
+            }
+
+            float *out = &(*result[i])[0][0];
+            for (int j = 0; j < 16; ++j) {
+                out[j] = r[j];
+            }
+        }
+    }
+
+#if defined(MATRIX_KERNELS_X86)
+    TARGET_SSE2
+    void multiplySSE(mat4 const *const *lhs, mat4 const *const *rhs,
+                     mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+
+            __m128 const a0 = _mm_loadu_ps(a + 0);
+            __m128 const a1 = _mm_loadu_ps(a + 4);
+            __m128 const a2 = _mm_loadu_ps(a + 8);
+            __m128 const a3 = _mm_loadu_ps(a + 12);
+
+            // Results go to registers first - result may alias an operand
+            __m128 r[4];
+            for (int column = 0; column < 4; ++column) {
+                __m128 const bc = _mm_loadu_ps(b + column * 4);
+
+                __m128 sum = _mm_mul_ps(
+                        a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(
+                        a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+                sum = _mm_add_ps(sum, _mm_mul_ps(
+                        a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+                sum = _mm_add_ps(sum, _mm_mul_ps(
+                        a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+                r[column] = sum;
+            }
+
+            float *out = &(*result[i])[0][0];
+            _mm_storeu_ps(out + 0, r[0]);
+            _mm_storeu_ps(out + 4, r[1]);
+            _mm_storeu_ps(out + 8, r[2]);
+            _mm_storeu_ps(out + 12, r[3]);
+        }
+    }
+
+    // As multiplyAffineScalar
+    TARGET_SSE2
+    void multiplyAffineSSE(mat4 const *const *lhs, mat4 const *const *rhs,
+                           mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+
+            __m128 const a0 = _mm_loadu_ps(a + 0);
+            __m128 const a1 = _mm_loadu_ps(a + 4);
+            __m128 const a2 = _mm_loadu_ps(a + 8);
+            __m128 const a3 = _mm_loadu_ps(a + 12);
+
+            // Results go to registers first - result may alias an operand
+            __m128 r[4];
+            for (int column = 0; column < 4; ++column) {
+                __m128 const bc = _mm_loadu_ps(b + column * 4);
+
+                __m128 sum = _mm_mul_ps(
+                        a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(
+                        a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+                sum = _mm_add_ps(sum, _mm_mul_ps(
+                        a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+                r[column] = sum;
+            }
+            r[3] = _mm_add_ps(r[3], a3);
+
+            float *out = &(*result[i])[0][0];
+            _mm_storeu_ps(out + 0, r[0]);
+            _mm_storeu_ps(out + 4, r[1]);
+            _mm_storeu_ps(out + 8, r[2]);
+            _mm_storeu_ps(out + 12, r[3]);
+        }
+    }
+
+    // Two result columns per 256-bit register: every lhs column is
+    // duplicated into both lanes, and an in-lane shuffle of two rhs
+    // columns broadcasts one element of each column into its own lane
+    TARGET_AVX2
+    void multiplyAVX2(mat4 const *const *lhs, mat4 const *const *rhs,
+                      mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+
+            __m256 const a0 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 0));
+            __m256 const a1 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 4));
+            __m256 const a2 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 8));
+            __m256 const a3 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 12));
+
+            __m256 const b01 = _mm256_loadu_ps(b + 0);
+            __m256 const b23 = _mm256_loadu_ps(b + 8);
+
+            __m256 r01 = _mm256_mul_ps(
+                    a0, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(0, 0, 0, 0)));
+            r01 = _mm256_fmadd_ps(
+                    a1, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+            r01 = _mm256_fmadd_ps(
+                    a2, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+            r01 = _mm256_fmadd_ps(
+                    a3, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(3, 3, 3, 3)), r01);
+
+            __m256 r23 = _mm256_mul_ps(
+                    a0, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(0, 0, 0, 0)));
+            r23 = _mm256_fmadd_ps(
+                    a1, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+            r23 = _mm256_fmadd_ps(
+                    a2, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+            r23 = _mm256_fmadd_ps(
+                    a3, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+            float *out = &(*result[i])[0][0];
+            _mm256_storeu_ps(out + 0, r01);
+            _mm256_storeu_ps(out + 8, r23);
+        }
+    }
+
+    // As multiplyAVX2; the last lhs column only goes into the last result
+    // column, added in the upper lane alone
+    TARGET_AVX2
+    void multiplyAffineAVX2(mat4 const *const *lhs, mat4 const *const *rhs,
+                            mat4 *const *result, size_t const count) {
+        for (size_t i = 0; i < count; ++i) {
+            float const *a = &(*lhs[i])[0][0];
+            float const *b = &(*rhs[i])[0][0];
+
+            __m256 const a0 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 0));
+            __m256 const a1 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 4));
+            __m256 const a2 = _mm256_broadcast_ps(
+                    reinterpret_cast<__m128 const *>(a + 8));
+            __m256 const a3 = _mm256_insertf128_ps(
+                    _mm256_setzero_ps(), _mm_loadu_ps(a + 12), 1);
+
+            __m256 const b01 = _mm256_loadu_ps(b + 0);
+            __m256 const b23 = _mm256_loadu_ps(b + 8);
+
+            __m256 r01 = _mm256_mul_ps(
+                    a0, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(0, 0, 0, 0)));
+            r01 = _mm256_fmadd_ps(
+                    a1, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+            r01 = _mm256_fmadd_ps(
+                    a2, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+
+            __m256 r23 = _mm256_fmadd_ps(
+                    a0, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(0, 0, 0, 0)), a3);
+            r23 = _mm256_fmadd_ps(
+                    a1, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+            r23 = _mm256_fmadd_ps(
+                    a2, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+
+            float *out = &(*result[i])[0][0];
+            _mm256_storeu_ps(out + 0, r01);
+            _mm256_storeu_ps(out + 8, r23);
+        }
+    }
+
+    // ----------------------------------------------- CPU features -- //
+    bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+
+        __cpuid(info, 1);
+        bool const fma = (info[2] & (1 << 12)) != 0;
+        bool const osxsave = (info[2] & (1 << 27)) != 0;
+        bool const avx = (info[2] & (1 << 28)) != 0;
+        if (!(fma && osxsave && avx)) {
+            return false;
+        }
+
+        // The OS has to save the YMM registers on context switches
+        if ((_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma");
+#endif
+    }
+
+    bool cpuSupportsSSE2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+#endif
+
+    vector<MatrixKernel> detectMatrixKernels() {
+        vector<MatrixKernel> kernels;
+        kernels.push_back({"Skalarny", multiplyScalar, multiplyAffineScalar});
+
+#if defined(MATRIX_KERNELS_X86)
+        if (cpuSupportsSSE2()) {
+            kernels.push_back({"SSE", multiplySSE, multiplyAffineSSE});
+        }
+        if (cpuSupportsAVX2()) {
+            kernels.push_back({"AVX2", multiplyAVX2, multiplyAffineAVX2});
+        }
+#endif
+
+        return kernels;
+    }
+}
+
+// ////////////////////////////////////////////////////// Matrix kernels //
+vector<MatrixKernel> const &getAvailableMatrixKernels() {
+    static vector<MatrixKernel> const kernels = detectMatrixKernels();
+    return kernels;
+}
+
+MatrixKernel const &getMatrixKernel() {
+    return getAvailableMatrixKernels().back();
+}
+
+// ///////////////////////////////////////////////////////////////////// //
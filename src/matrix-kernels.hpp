@@ -0,0 +1,35 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// ////////////////////////////////////////////////////// Matrix kernels //
+// Batched 4x4 products: *result[i] = *lhs[i] * *rhs[i]. Operands are
+// passed as pointer arrays so callers can gather parents and locals from
+// wherever they live without copying them first.
+using MatrixBatchKernel = void (*)(glm::mat4 const *const *lhs,
+                                   glm::mat4 const *const *rhs,
+                                   glm::mat4 *const *result,
+                                   std::size_t count);
+
+// multiplyAffine takes operands whose bottom row is (0, 0, 0, 1), such
+// as products of translations, rotations and scales, and skips the terms
+// of the rhs bottom row: the products with its zeros are left out and
+// the one with its 1 becomes an addition
+struct MatrixKernel {
+    char const *name;
+    MatrixBatchKernel multiply;
+    MatrixBatchKernel multiplyAffine;
+};
+
+// Kernels usable on this CPU, from the scalar fallback up to the widest
+std::vector<MatrixKernel> const &getAvailableMatrixKernels();
+
+// Widest available kernel, picked once by CPU feature detection
+MatrixKernel const &getMatrixKernel();
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // MATRIX_KERNELS_H
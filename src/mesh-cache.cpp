@@ -0,0 +1,422 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "mesh-cache.hpp"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::ofstream;
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    char const MAGIC[4] = {'T', 'P', 'M', 'C'};
+    char const EXTENSION[] = ".mesh-cache";
+
+    // Every block in the file starts at a multiple of four bytes, so the
+    // vertices and indices can be used in place
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t importFlags;
+        uint32_t pathLength;
+        uint64_t modificationTime;
+        uint64_t sourceSize;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    // Followed by the level sizes, the texture names, the vertices and
+    // the index lists
+    struct EntryHeader {
+        uint32_t vertexCount;
+        uint32_t levelCount;
+        uint32_t textureCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        float sphereCenter[3];
+        float sphereRadius;
+    };
+
+    std::size_t padded(std::size_t const size) {
+        return (size + 3) & ~std::size_t(3);
+    }
+
+    // The modification time is taken at the file system's full
+    // resolution, not in whole seconds, so a source rewritten within the
+    // second its cache was made still invalidates it
+    bool getSourceStamp(string const &path,
+                        uint64_t &modificationTime, uint64_t &size) {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard,
+                                  &attributes)) {
+            return false;
+        }
+        // In 100 ns ticks
+        modificationTime =
+                (uint64_t(attributes.ftLastWriteTime.dwHighDateTime) << 32)
+                | attributes.ftLastWriteTime.dwLowDateTime;
+        size = (uint64_t(attributes.nFileSizeHigh) << 32)
+               | attributes.nFileSizeLow;
+#else
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0) {
+            return false;
+        }
+#ifdef __APPLE__
+        timespec const &time = status.st_mtimespec;
+#else
+        timespec const &time = status.st_mtim;
+#endif
+        // In nanoseconds
+        modificationTime = static_cast<uint64_t>(time.tv_sec) * 1000000000u
+                           + static_cast<uint64_t>(time.tv_nsec);
+        size = static_cast<uint64_t>(status.st_size);
+#endif
+        return true;
+    }
+
+    // Bounds-checked walk over the mapped file; a truncated or damaged
+    // cache makes a read fail instead of running off the end
+    class Reader {
+    public:
+        Reader(void const *data, std::size_t const size)
+                : position(static_cast<char const *>(data)),
+                  end(position + size) {
+        }
+
+        template <typename T>
+        bool read(T &value) {
+            if (sizeof(T) > remaining()) {
+                return false;
+            }
+            std::memcpy(&value, position, sizeof(T));
+            position += padded(sizeof(T));
+            return true;
+        }
+
+        template <typename T>
+        bool take(std::size_t const count, T const *&values) {
+            if (count > remaining() / sizeof(T)) {
+                return false;
+            }
+            values = reinterpret_cast<T const *>(position);
+            position += std::min(padded(count * sizeof(T)), remaining());
+            return true;
+        }
+
+        // Whether count records of at least recordSize bytes each can
+        // still follow; checked before sizing anything by a count read
+        // from the file, so a damaged count is a miss, not a huge
+        // allocation
+        bool canHold(std::size_t const count,
+                     std::size_t const recordSize) const {
+            return count <= remaining() / recordSize;
+        }
+
+        bool readString(string &value) {
+            uint32_t length;
+            char const *characters;
+            if (!read(length) || !take(length, characters)) {
+                return false;
+            }
+            value.assign(characters, length);
+            return true;
+        }
+
+    private:
+        char const *position;
+        char const *const end;
+
+        std::size_t remaining() const {
+            return static_cast<std::size_t>(end - position);
+        }
+    };
+
+    class Writer {
+    public:
+        explicit Writer(string const &path)
+                : file(path, std::ios::binary | std::ios::trunc) {
+        }
+
+        template <typename T>
+        void write(T const &value) {
+            writeArray(&value, 1);
+        }
+
+        template <typename T>
+        void writeArray(T const *const values, std::size_t const count) {
+            std::size_t const size = count * sizeof(T);
+            char const zeros[4] = {};
+
+            file.write(reinterpret_cast<char const *>(values), size);
+            file.write(zeros, padded(size) - size);
+        }
+
+        void writeString(string const &value) {
+            write(static_cast<uint32_t>(value.size()));
+            writeArray(value.data(), value.size());
+        }
+
+        bool finish() {
+            file.close();
+            return !file.fail();
+        }
+
+    private:
+        ofstream file;
+    };
+}
+
+// //////////////////////////////////////////////////// Class: MeshCache //
+unsigned int const MeshCache::VERSION;
+
+MeshCache::MeshCache()
+        : mapping(nullptr),
+          mappingSize(0) {
+}
+
+MeshCache::~MeshCache() {
+    close();
+}
+
+bool MeshCache::open(string const &sourcePath,
+                     unsigned int const importFlags) {
+    close();
+
+    if (!map(sourcePath + EXTENSION) || !parse(sourcePath, importFlags)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCache::close() {
+    entries.clear();
+
+    if (mapping != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(const_cast<void *>(mapping), mappingSize);
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+}
+
+vector<MeshCache::Entry> const &MeshCache::getEntries() const {
+    return entries;
+}
+
+bool MeshCache::write(string const &sourcePath,
+                      unsigned int const importFlags,
+                      vector<Entry> const &entries) {
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.importFlags = importFlags;
+    header.pathLength = static_cast<uint32_t>(sourcePath.size());
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    if (!getSourceStamp(sourcePath, header.modificationTime,
+                        header.sourceSize)) {
+        return false;
+    }
+
+    // Written aside and moved into place, so a cache that is still being
+    // written is never mistaken for a complete one
+    string const path = sourcePath + EXTENSION;
+    string const temporaryPath = path + ".tmp";
+    Writer writer(temporaryPath);
+
+    writer.write(header);
+    writer.writeArray(sourcePath.data(), sourcePath.size());
+
+    for (auto const &entry : entries) {
+        EntryHeader const entryHeader = {
+                static_cast<uint32_t>(entry.vertexCount),
+                static_cast<uint32_t>(entry.levels.size()),
+                static_cast<uint32_t>(entry.textures.size()),
+                {entry.bounds.min.x, entry.bounds.min.y, entry.bounds.min.z},
+                {entry.bounds.max.x, entry.bounds.max.y, entry.bounds.max.z},
+                {entry.boundingSphere.center.x,
+                 entry.boundingSphere.center.y,
+                 entry.boundingSphere.center.z},
+                entry.boundingSphere.radius};
+        writer.write(entryHeader);
+
+        for (auto const &level : entry.levels) {
+            writer.write(static_cast<uint32_t>(level.size));
+        }
+        for (auto const &texture : entry.textures) {
+            writer.writeString(texture);
+        }
+        writer.writeArray(entry.vertices, entry.vertexCount);
+        for (auto const &level : entry.levels) {
+            writer.writeArray(level.data, level.size);
+        }
+    }
+
+    if (!writer.finish()) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool MeshCache::map(string const &path) {
+    // The view keeps the file open, so the handles can go right away
+#ifdef _WIN32
+    HANDLE const file = CreateFileA(path.c_str(), GENERIC_READ,
+                                    FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE fileMapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY,
+                                         0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (fileMapping == nullptr) {
+        return false;
+    }
+
+    mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(fileMapping);
+    if (mapping == nullptr) {
+        return false;
+    }
+    mappingSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    int const file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat status;
+    void *view = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(status.st_size),
+                    PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    ::close(file);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    mapping = view;
+    mappingSize = static_cast<std::size_t>(status.st_size);
+#endif
+    return true;
+}
+
+bool MeshCache::parse(string const &sourcePath,
+                      unsigned int const importFlags) {
+    Reader reader(mapping, mappingSize);
+
+    // The key: format, import settings and the exact source file
+    Header header;
+    char const *path;
+    uint64_t modificationTime, sourceSize;
+    if (!reader.read(header)
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != VERSION
+        || header.importFlags != importFlags
+        || !reader.take(header.pathLength, path)
+        || sourcePath.compare(0, string::npos,
+                              path, header.pathLength) != 0
+        || !getSourceStamp(sourcePath, modificationTime, sourceSize)
+        || header.modificationTime != modificationTime
+        || header.sourceSize != sourceSize) {
+        return false;
+    }
+
+    if (!reader.canHold(header.entryCount, padded(sizeof(EntryHeader)))) {
+        return false;
+    }
+    entries.resize(header.entryCount);
+    for (auto &entry : entries) {
+        // A level takes at least its size, a texture name its length
+        EntryHeader entryHeader;
+        if (!reader.read(entryHeader) || entryHeader.levelCount == 0
+            || !reader.canHold(entryHeader.levelCount, sizeof(uint32_t))) {
+            return false;
+        }
+
+        entry.vertexCount = entryHeader.vertexCount;
+        entry.levels.resize(entryHeader.levelCount);
+        for (auto &level : entry.levels) {
+            uint32_t size;
+            if (!reader.read(size)) {
+                return false;
+            }
+            level.size = size;
+        }
+
+        if (!reader.canHold(entryHeader.textureCount, sizeof(uint32_t))) {
+            return false;
+        }
+        entry.textures.resize(entryHeader.textureCount);
+        for (auto &texture : entry.textures) {
+            if (!reader.readString(texture)) {
+                return false;
+            }
+        }
+
+        if (!reader.take(entry.vertexCount, entry.vertices)) {
+            return false;
+        }
+        // The lists go to the GPU as they are, so one that is not made of
+        // whole triangles or points past the vertices is a miss, not an
+        // out-of-bounds read on the GPU
+        for (auto &level : entry.levels) {
+            if (!reader.take(level.size, level.data)
+                || level.size % 3 != 0
+                || std::any_of(level.data, level.data + level.size,
+                               [&entry](unsigned int const index) {
+                                   return index >= entry.vertexCount;
+                               })) {
+                return false;
+            }
+        }
+
+        entry.bounds = BoundingBox(
+                glm::vec3(entryHeader.boundsMin[0], entryHeader.boundsMin[1],
+                          entryHeader.boundsMin[2]),
+                glm::vec3(entryHeader.boundsMax[0], entryHeader.boundsMax[1],
+                          entryHeader.boundsMax[2]));
+        entry.boundingSphere = BoundingSphere(
+                glm::vec3(entryHeader.sphereCenter[0],
+                          entryHeader.sphereCenter[1],
+                          entryHeader.sphereCenter[2]),
+                entryHeader.sphereRadius);
+    }
+    return true;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,74 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+#include "geometry-buffer.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// //////////////////////////////////////////////////// Class: MeshCache //
+// Binary snapshot of an imported model, stored next to it as
+// <source>.mesh-cache: for every mesh, its vertices, the index lists of
+// all its detail levels, its texture file names and its bounds. A cache
+// is only used when the source path, the source's modification time and
+// size, the import flags and the format version all match; anything else
+// counts as a miss and the model is imported and cached again. Data is
+// in the native byte order - the file is not meant to move between
+// machines.
+//
+// A cache that was opened is mapped into memory rather than read, so the
+// arrays handed out point straight into the file and stay valid until
+// the cache is closed or destroyed.
+class MeshCache {
+public:
+    struct Indices {
+        unsigned int const *data;
+        std::size_t size;
+    };
+
+    struct Entry {
+        Vertex const *vertices;
+        std::size_t vertexCount;
+        // Full detail first
+        std::vector<Indices> levels;
+        std::vector<std::string> textures;
+        BoundingBox bounds;
+        BoundingSphere boundingSphere;
+    };
+
+    MeshCache();
+    ~MeshCache();
+
+    MeshCache(MeshCache const &) = delete;
+    MeshCache &operator=(MeshCache const &) = delete;
+
+    // False when there is no usable cache for the source
+    bool open(std::string const &sourcePath, unsigned int importFlags);
+    void close();
+
+    std::vector<Entry> const &getEntries() const;
+
+    // Replaces the source's cache; false if it could not be written,
+    // which leaves the model to be imported again next time
+    static bool write(std::string const &sourcePath,
+                      unsigned int importFlags,
+                      std::vector<Entry> const &entries);
+
+private:
+    // Bump whenever the layout changes, or anything that produces the
+    // cached data does, e.g. the mesh simplifier
+    static unsigned int const VERSION = 3;
+
+    void const *mapping;
+    std::size_t mappingSize;
+
+    std::vector<Entry> entries;
+
+    bool map(std::string const &path);
+    bool parse(std::string const &sourcePath, unsigned int importFlags);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // MESH_CACHE_H
@@ -0,0 +1,499 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "mesh-simplifier.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::dvec3;
+
+using std::size_t;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // What may happen to a vertex, from freest to most constrained
+    enum VertexKind : std::uint8_t {
+        MANIFOLD,
+        // On an open edge; may only collapse along it
+        BORDER,
+        // On a non-manifold edge; texture seams are kept by the collapse
+        // checks instead, see matchVertices()
+        LOCKED
+    };
+
+    unsigned int const NONE = ~0u;
+
+    // Border edges get a plane standing on them, perpendicular to their
+    // triangle, so collapses keep the outline; weighted against the
+    // area-weighted planes of the faces
+    double const BORDER_WEIGHT = 10.0;
+
+    // Sum of squared distances to a set of planes, as the upper half of
+    // a symmetric 4x4 matrix
+    struct Quadric {
+        double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+        Quadric()
+                : a2(0.0), ab(0.0), ac(0.0), ad(0.0), b2(0.0),
+                  bc(0.0), bd(0.0), c2(0.0), cd(0.0), d2(0.0) {
+        }
+
+        // Plane dot(normal, p) + d = 0, normal of unit length
+        Quadric(dvec3 const &normal, double const d, double const weight)
+                : a2(weight * normal.x * normal.x),
+                  ab(weight * normal.x * normal.y),
+                  ac(weight * normal.x * normal.z),
+                  ad(weight * normal.x * d),
+                  b2(weight * normal.y * normal.y),
+                  bc(weight * normal.y * normal.z),
+                  bd(weight * normal.y * d),
+                  c2(weight * normal.z * normal.z),
+                  cd(weight * normal.z * d),
+                  d2(weight * d * d) {
+        }
+
+        Quadric &operator+=(Quadric const &other) {
+            a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+            b2 += other.b2; bc += other.bc; bd += other.bd;
+            c2 += other.c2; cd += other.cd;
+            d2 += other.d2;
+            return *this;
+        }
+
+        double evaluate(dvec3 const &p) const {
+            return p.x * (a2 * p.x + 2.0 * (ab * p.y + ac * p.z + ad)) +
+                   p.y * (b2 * p.y + 2.0 * (bc * p.z + bd)) +
+                   p.z * (c2 * p.z + 2.0 * cd) +
+                   d2;
+        }
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double cost;
+    };
+
+    dvec3 positionOf(vector<Vertex> const &vertices, unsigned int const i) {
+        return dvec3(vertices[i].position);
+    }
+
+    std::uint64_t edgeKey(unsigned int a, unsigned int b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+        return (static_cast<std::uint64_t>(a) << 32) | b;
+    }
+
+    // ------------------------------------------------------ Welding -- //
+    // For every vertex, the lowest index of a vertex whose first
+    // floatCount floats are bitwise equal to its own
+    vector<unsigned int> weld(vector<Vertex> const &vertices,
+                              size_t const floatCount) {
+        static_assert(sizeof(Vertex) == 5 * sizeof(float),
+                      "Vertex is expected to be five tightly packed floats");
+        size_t const size = floatCount * sizeof(float);
+
+        vector<unsigned int> order(vertices.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(),
+                  [&](unsigned int const a, unsigned int const b) {
+                      int const comparison = std::memcmp(&vertices[a],
+                                                         &vertices[b], size);
+                      return comparison != 0 ? comparison < 0 : a < b;
+                  });
+
+        vector<unsigned int> representatives(vertices.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            bool const sameAsPrevious = i > 0 &&
+                    std::memcmp(&vertices[order[i]],
+                                &vertices[order[i - 1]], size) == 0;
+            representatives[order[i]] =
+                    sameAsPrevious ? representatives[order[i - 1]]
+                                   : order[i];
+        }
+        return representatives;
+    }
+
+    // ----------------------------------------------------- Topology -- //
+    // Classifies the positions used by triangles and collects the sorted
+    // keys of the edges only one triangle uses. Edges are taken between
+    // positions, so texture seams do not count as open.
+    void analyseTopology(vector<unsigned int> const &triangles,
+                         vector<unsigned int> const &positions,
+                         vector<VertexKind> &kinds,
+                         vector<std::uint64_t> &borderEdges) {
+        vector<std::uint64_t> edges;
+        edges.reserve(triangles.size());
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            for (int corner = 0; corner < 3; ++corner) {
+                edges.push_back(edgeKey(
+                        positions[triangles[i + corner]],
+                        positions[triangles[i + (corner + 1) % 3]]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::fill(kinds.begin(), kinds.end(), MANIFOLD);
+        borderEdges.clear();
+
+        for (size_t first = 0; first < edges.size();) {
+            size_t last = first + 1;
+            while (last < edges.size() && edges[last] == edges[first]) {
+                ++last;
+            }
+
+            auto const a = static_cast<unsigned int>(edges[first] >> 32),
+                       b = static_cast<unsigned int>(edges[first]);
+            if (last - first == 1) {
+                kinds[a] = std::max(kinds[a], BORDER);
+                kinds[b] = std::max(kinds[b], BORDER);
+                borderEdges.push_back(edges[first]);
+            } else if (last - first > 2) {
+                kinds[a] = kinds[b] = LOCKED;
+            }
+            first = last;
+        }
+    }
+
+    // ----------------------------------------------------- Quadrics -- //
+    // One quadric per position, so both sides of a seam see the whole
+    // surface around it
+    vector<Quadric> computeQuadrics(
+            vector<Vertex> const &vertices,
+            vector<unsigned int> const &triangles,
+            vector<unsigned int> const &positions,
+            vector<std::uint64_t> const &borderEdges) {
+        vector<Quadric> quadrics(vertices.size());
+
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            unsigned int const corners[3] = {positions[triangles[i]],
+                                             positions[triangles[i + 1]],
+                                             positions[triangles[i + 2]]};
+            dvec3 const p[3] = {positionOf(vertices, corners[0]),
+                                positionOf(vertices, corners[1]),
+                                positionOf(vertices, corners[2])};
+
+            dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+            double const length = glm::length(normal);
+            if (length == 0.0) {
+                continue;
+            }
+            normal /= length;
+
+            Quadric const face(normal, -glm::dot(normal, p[0]),
+                               0.5 * length);
+            for (int corner = 0; corner < 3; ++corner) {
+                quadrics[corners[corner]] += face;
+            }
+
+            for (int corner = 0; corner < 3; ++corner) {
+                int const next = (corner + 1) % 3;
+                if (!std::binary_search(borderEdges.begin(),
+                                        borderEdges.end(),
+                                        edgeKey(corners[corner],
+                                                corners[next]))) {
+                    continue;
+                }
+
+                dvec3 const edge = p[next] - p[corner];
+                dvec3 side = glm::cross(edge, normal);
+                double const sideLength = glm::length(side);
+                if (sideLength == 0.0) {
+                    continue;
+                }
+                side /= sideLength;
+
+                Quadric const border(side, -glm::dot(side, p[corner]),
+                                     BORDER_WEIGHT * glm::dot(edge, edge));
+                quadrics[corners[corner]] += border;
+                quadrics[corners[next]] += border;
+            }
+        }
+        return quadrics;
+    }
+
+    // ---------------------------------------------------- Collapses -- //
+    // Pairs each vertex at from's position with the vertex at to's
+    // position it shares a triangle with. A vertex without one sits on a
+    // texture chart the edge does not touch, so moving it would tear a
+    // seam; unless seams may be broken, the collapse is refused, and
+    // otherwise the vertex takes the closest texture coordinates at to.
+    bool matchVertices(vector<Vertex> const &vertices,
+                       vector<unsigned int> const &triangles,
+                       vector<unsigned int> const &positions,
+                       unsigned int const *firstTriangle,
+                       unsigned int const *lastTriangle,
+                       unsigned int const from, unsigned int const to,
+                       bool const preserveSeams,
+                       vector<std::pair<unsigned int, unsigned int>> &pairs) {
+        pairs.clear();
+        for (unsigned int const *t = firstTriangle; t != lastTriangle; ++t) {
+            unsigned int const *corners = &triangles[3 * *t];
+            unsigned int fromVertex = NONE, toVertex = NONE;
+            for (int corner = 0; corner < 3; ++corner) {
+                if (positions[corners[corner]] == from) {
+                    fromVertex = corners[corner];
+                } else if (positions[corners[corner]] == to) {
+                    toVertex = corners[corner];
+                }
+            }
+            if (toVertex != NONE) {
+                pairs.emplace_back(fromVertex, toVertex);
+            }
+        }
+        if (pairs.empty()) {
+            return false;
+        }
+
+        std::size_t const sharedCount = pairs.size();
+        for (unsigned int const *t = firstTriangle; t != lastTriangle; ++t) {
+            unsigned int const *corners = &triangles[3 * *t];
+            unsigned int fromVertex = corners[0];
+            for (int corner = 1; corner < 3; ++corner) {
+                if (positions[corners[corner]] == from) {
+                    fromVertex = corners[corner];
+                }
+            }
+
+            bool matched = false;
+            for (auto const &pair : pairs) {
+                matched = matched || pair.first == fromVertex;
+            }
+            if (matched) {
+                continue;
+            }
+            if (preserveSeams) {
+                return false;
+            }
+
+            glm::vec2 const texCoords = vertices[fromVertex].texCoords;
+            unsigned int closest = pairs[0].second;
+            float closestDistance = std::numeric_limits<float>::max();
+            for (std::size_t i = 0; i < sharedCount; ++i) {
+                glm::vec2 const offset =
+                        vertices[pairs[i].second].texCoords - texCoords;
+                float const distance = offset.x * offset.x +
+                                       offset.y * offset.y;
+                if (distance < closestDistance) {
+                    closest = pairs[i].second;
+                    closestDistance = distance;
+                }
+            }
+            pairs.emplace_back(fromVertex, closest);
+        }
+        return true;
+    }
+
+    // Whether moving from onto to turns any of from's surviving
+    // triangles over
+    bool flipsTriangle(vector<Vertex> const &vertices,
+                       vector<unsigned int> const &triangles,
+                       vector<unsigned int> const &positions,
+                       unsigned int const *firstTriangle,
+                       unsigned int const *lastTriangle,
+                       unsigned int const from, unsigned int const to) {
+        dvec3 const target = positionOf(vertices, to);
+
+        for (unsigned int const *t = firstTriangle; t != lastTriangle; ++t) {
+            unsigned int const corners[3] = {positions[triangles[3 * *t]],
+                                             positions[triangles[3 * *t + 1]],
+                                             positions[triangles[3 * *t + 2]]};
+            if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                continue;
+            }
+
+            dvec3 before[3], after[3];
+            for (int corner = 0; corner < 3; ++corner) {
+                before[corner] = positionOf(vertices, corners[corner]);
+                after[corner] = corners[corner] == from ? target
+                                                        : before[corner];
+            }
+
+            dvec3 const normalBefore = glm::cross(before[1] - before[0],
+                                                  before[2] - before[0]);
+            dvec3 const normalAfter = glm::cross(after[1] - after[0],
+                                                 after[2] - after[0]);
+            if (glm::dot(normalBefore, normalAfter) <= 0.0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Drops triangles left with two corners at one position
+    void removeDegenerate(vector<unsigned int> &triangles,
+                          vector<unsigned int> const &positions) {
+        size_t kept = 0;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            unsigned int const a = triangles[i],
+                               b = triangles[i + 1],
+                               c = triangles[i + 2];
+            if (positions[a] != positions[b] &&
+                positions[b] != positions[c] &&
+                positions[c] != positions[a]) {
+                triangles[kept++] = a;
+                triangles[kept++] = b;
+                triangles[kept++] = c;
+            }
+        }
+        triangles.resize(kept);
+    }
+}
+
+// ////////////////////////////////////////////////////// Simplification //
+vector<unsigned int> simplifyMesh(vector<Vertex> const &vertices,
+                                  vector<unsigned int> const &indices,
+                                  size_t const targetIndexCount) {
+    // Importers tend to give every face corner its own vertex, so equal
+    // vertices are merged first. The surface is connected through equal
+    // positions; vertices differing only in texture coordinates are the
+    // two sides of a seam.
+    vector<unsigned int> const wedges = weld(vertices, 5);
+    vector<unsigned int> const positions = weld(vertices, 3);
+
+    vector<unsigned int> triangles;
+    triangles.reserve(indices.size());
+    for (size_t i = 0; i < indices.size() / 3 * 3; ++i) {
+        triangles.push_back(wedges[indices[i]]);
+    }
+    removeDegenerate(triangles, positions);
+
+    vector<VertexKind> kinds(vertices.size());
+    vector<std::uint64_t> borderEdges;
+    analyseTopology(triangles, positions, kinds, borderEdges);
+
+    vector<Quadric> quadrics = computeQuadrics(vertices, triangles,
+                                               positions, borderEdges);
+
+    size_t const targetTriangleCount = targetIndexCount / 3;
+    vector<Collapse> collapses;
+    vector<unsigned int> remap(vertices.size());
+    vector<bool> touched(vertices.size());
+    vector<unsigned int> adjacencyOffsets(vertices.size() + 1);
+    vector<unsigned int> adjacency;
+    vector<std::pair<unsigned int, unsigned int>> pairs;
+    bool preserveSeams = true;
+
+    // Each pass ranks every candidate collapse by its error and applies
+    // the cheapest ones that do not share triangles, so that the checks
+    // made for one are not invalidated by another
+    while (triangles.size() / 3 > targetTriangleCount) {
+        size_t const triangleCount = triangles.size() / 3;
+
+        // Collapses join positions; the vertices follow when applied
+        collapses.clear();
+        auto const addCandidate = [&](unsigned int const from,
+                                      unsigned int const to) {
+            if (kinds[from] == LOCKED ||
+                (kinds[from] == BORDER &&
+                 !std::binary_search(borderEdges.begin(), borderEdges.end(),
+                                     edgeKey(from, to)))) {
+                return;
+            }
+
+            Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+            collapses.push_back({from, to,
+                                 quadric.evaluate(positionOf(vertices, to))});
+        };
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            for (int corner = 0; corner < 3; ++corner) {
+                int const next = (corner + 1) % 3;
+                unsigned int const a = positions[triangles[i + corner]],
+                                   b = positions[triangles[i + next]];
+                addCandidate(a, b);
+                addCandidate(b, a);
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](Collapse const &a, Collapse const &b) {
+                      return a.cost < b.cost;
+                  });
+
+        // Triangles around each position
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+        for (unsigned int const vertex : triangles) {
+            ++adjacencyOffsets[positions[vertex] + 1];
+        }
+        std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(),
+                         adjacencyOffsets.begin());
+        adjacency.resize(triangles.size());
+        {
+            vector<unsigned int> cursor(adjacencyOffsets.begin(),
+                                        adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triangles.size(); ++i) {
+                adjacency[cursor[positions[triangles[i]]]++] =
+                        static_cast<unsigned int>(i / 3);
+            }
+        }
+
+        // An interior collapse removes two triangles
+        size_t const budget = std::max<size_t>(
+                (triangleCount - targetTriangleCount) / 2, 1);
+        size_t collapsed = 0;
+
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(touched.begin(), touched.end(), false);
+
+        for (Collapse const &collapse : collapses) {
+            if (collapsed >= budget) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+
+            unsigned int const *first =
+                    adjacency.data() + adjacencyOffsets[collapse.from];
+            unsigned int const *last =
+                    adjacency.data() + adjacencyOffsets[collapse.from + 1];
+            if (!matchVertices(vertices, triangles, positions, first, last,
+                               collapse.from, collapse.to, preserveSeams,
+                               pairs) ||
+                flipsTriangle(vertices, triangles, positions, first, last,
+                              collapse.from, collapse.to)) {
+                continue;
+            }
+
+            for (auto const &pair : pairs) {
+                remap[pair.first] = pair.second;
+            }
+            quadrics[collapse.to] += quadrics[collapse.from];
+
+            for (unsigned int const *t = first; t != last; ++t) {
+                for (int corner = 0; corner < 3; ++corner) {
+                    touched[positions[triangles[3 * *t + corner]]] = true;
+                }
+            }
+            ++collapsed;
+        }
+        // Meshes cut into many charts run out of collapses along seams
+        // early; past that point texture coordinates give way
+        if (collapsed == 0) {
+            if (!preserveSeams) {
+                break;
+            }
+            preserveSeams = false;
+            continue;
+        }
+
+        for (unsigned int &vertex : triangles) {
+            vertex = remap[vertex];
+        }
+        removeDegenerate(triangles, positions);
+
+        analyseTopology(triangles, positions, kinds, borderEdges);
+    }
+
+    return triangles;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
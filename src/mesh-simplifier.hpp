@@ -0,0 +1,24 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "geometry-buffer.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// ///////////////////////////////////////////////// Mesh simplification //
+// Quadric error edge collapse (Garland-Heckbert). Vertices only ever
+// collapse onto a neighbour, never to a new position, so the result
+// indexes the same vertex array as the input and a simplified level can
+// share the vertices of the full mesh. Open borders only slide along
+// themselves and vertices on non-manifold edges stay put, which can stop
+// the simplifier above the target. Texture seams are kept while anything
+// else can collapse; after that, vertices are pulled across them and take
+// the nearest texture coordinates on the other side.
+std::vector<unsigned int> simplifyMesh(
+        std::vector<Vertex> const &vertices,
+        std::vector<unsigned int> const &indices,
+        std::size_t targetIndexCount);
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // MESH_SIMPLIFIER_H
@@ -1,65 +1,82 @@
 // //////////////////////////////////////////////////////////// Includes //
 #include "mesh.hpp"
+#include "mesh-simplifier.hpp"
+#include "renderable.hpp"
 
 #include "opengl-headers.hpp"
 
+#include <algorithm>
+#include <utility>
+
 // ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+
 using std::vector;
-using std::shared_ptr;
 
 // ///////////////////////////////////////////////////////////////////// // 
-Mesh::Mesh(vector<Vertex> const &vertices,
-           vector<unsigned int> const &indices,
-           vector<Texture> const &textures)
-        : vertices(vertices),
-          indices(indices),
-          textures(textures) {
+std::size_t const Mesh::MIN_LEVEL_INDEX_COUNT;
+
+Mesh::Mesh(GLuint const vao,
+           vector<GeometryRange> const &levels,
+           vector<Texture> const &textures,
+           BoundingBox const &bounds,
+           BoundingSphere const &boundingSphere)
+        : vao(vao),
+          levels(levels),
+          textures(textures),
+          bounds(bounds),
+          boundingSphere(boundingSphere) {
 }
 
-void Mesh::render(shared_ptr<Shader> shader,
-                  GLuint const overrideTexture) const {
-    shader->use();
-    shader->uniform1i("texture0", 0);
+void Mesh::enqueue(RenderQueue &queue, Renderable const &owner,
+                   mat4 const &world,
+                   GLuint const overrideTexture,
+                   int const level) const {
+    DrawItem item;
+    item.renderable = &owner;
+    item.shader = owner.shader.get();
+    item.world = &world;
+    item.boundingSphere = &boundingSphere;
+    item.texture = (overrideTexture != 0) ? overrideTexture
+                                          : textures[0].id;
+    item.vao = vao;
+    item.mode = GL_TRIANGLES;
+    item.geometry = levels[std::min<std::size_t>(level,
+                                                  levels.size() - 1)];
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, (overrideTexture != 0)
-                                 ? overrideTexture
-                                 : textures[0].id);
-    glBindVertexArray(vao);
-        glDrawElements(GL_TRIANGLES, indices.size(),
-                       GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    queue.add(item);
 }
 
-void Mesh::setupMesh() {
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao); {
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+vector<vector<unsigned int>> Mesh::simplify(
+        vector<Vertex> const &vertices,
+        vector<unsigned int> const &indices) {
+    vector<vector<unsigned int>> levels;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    for (int level = 1; level < Renderable::LEVEL_COUNT; ++level) {
+        std::size_t const target = (indices.size() / 3 >> level) * 3;
+        if (target < MIN_LEVEL_INDEX_COUNT) {
+            break;
+        }
 
-        glEnableVertexAttribArray(0);	
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        vector<unsigned int> const &previous =
+                levels.empty() ? indices : levels.back();
+        vector<unsigned int> simplified =
+                simplifyMesh(vertices, previous, target);
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3)));
+        // Locked seams and borders can stop the simplifier early; a level
+        // that is hardly any smaller is not worth switching to
+        if (4 * simplified.size() > 3 * previous.size()) {
+            break;
+        }
+        levels.push_back(std::move(simplified));
     }
-    glBindVertexArray(0);
+    return levels;
 }
 
 Mesh::~Mesh() {
 //    for (auto const &texture : textures) {
 //        glDeleteTextures(1, &texture.id);
 //    }
-//    glDeleteBuffers(1, &ebo);
-//    glDeleteBuffers(1, &vbo);
-//    glDeleteVertexArrays(1, &vao);
 }
 
 // ///////////////////////////////////////////////////////////////////// // 
@@ -1,20 +1,18 @@
 #ifndef MESH_H
 #define MESH_H
 // //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+#include "geometry-buffer.hpp"
+#include "render-queue.hpp"
 #include "shader.hpp"
 
 #include "opengl-headers.hpp"
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <memory>
 
-// ////////////////////////////////////////////////////// Struct: Vertex //
-struct Vertex {
-    glm::vec3 position;
-    glm::vec2 texCoords;
-};
-
 // ///////////////////////////////////////////////////// Struct: Texture //
 struct Texture {
     GLuint id;
@@ -24,23 +22,41 @@ struct Texture {
 // ///////////////////////////////////////////////////////// Class: Mesh //
 class Mesh {
 public:
-
-    Mesh(std::vector<Vertex> const &vertices,
-         std::vector<unsigned int> const &indices,
-         std::vector<Texture> const &textures);
+    // The mesh's vertices and every detail level have to be in the
+    // geometry buffer already
+    Mesh(GLuint vao,
+         std::vector<GeometryRange> const &levels,
+         std::vector<Texture> const &textures,
+         BoundingBox const &bounds,
+         BoundingSphere const &boundingSphere);
 
     ~Mesh();
 
-    void render(std::shared_ptr<Shader> shader,
-                GLuint const overrideTexture = 0) const;
+    void enqueue(RenderQueue &queue, Renderable const &owner,
+                 glm::mat4 const &world,
+                 GLuint const overrideTexture = 0,
+                 int const level = 0) const;
 
-public:
-    void setupMesh();
+    // Index lists of the simplified levels below the full one, each built
+    // from the one before it. Needs no OpenGL context, so it can run
+    // while a model is imported on a worker thread.
+    static std::vector<std::vector<unsigned int>> simplify(
+            std::vector<Vertex> const &vertices,
+            std::vector<unsigned int> const &indices);
 
-    unsigned int vao, vbo, ebo;
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+public:
+    GLuint vao;
+    // Full detail first; every level shares the vertices of the first
+    std::vector<GeometryRange> levels;
     std::vector<Texture> textures;
+
+    // Model-space bounds, computed at import time
+    BoundingBox bounds;
+    BoundingSphere boundingSphere;
+
+private:
+    // Meshes with fewer indices than this stay at full detail
+    static std::size_t const MIN_LEVEL_INDEX_COUNT = 3 * 32;
 };
 // ///////////////////////////////////////////////////////////////////// //
 #endif // MESH_H
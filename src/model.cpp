@@ -10,39 +10,106 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
 #include <exception>
-#include <vector>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 // ////////////////////////////////////////////////////////////// Usings //
 using std::exception;
+using std::make_unique;
 using std::string;
 using std::vector;
-using std::shared_ptr;
 
+using glm::mat4;
 using glm::vec2;
 using glm::vec3;
 
-// ///////////////////////////////////////////////////////////////////// //
-GLuint loadTextureFromFile(string const &filename);
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Part of the mesh cache key
+    unsigned int const IMPORT_FLAGS =
+            aiProcess_Triangulate/* | aiProcess_FlipUVs*/;
+}
 
 // ///////////////////////////////////////////////////////////////////// //
-Model::Model(string const &path) {
-    loadModel(path);
+ModelData Model::import(string const &path) {
+    ModelData data;
+
+    data.cache = make_unique<MeshCache>();
+    if (data.cache->open(path, IMPORT_FLAGS)) {
+        data.meshes = data.cache->getEntries();
+    } else {
+        data.cache = nullptr;
+        loadModel(path, data);
+    }
+    return data;
 }
 
-void Model::render(shared_ptr<Shader> shader0,
-                   GLuint const overrideTexture) const {
+Model::Model(ModelData const &data, GeometryBuffer &geometryBuffer,
+             TextureCache &textureCache)
+        : textureCache(&textureCache) {
+    setup(data, geometryBuffer);
+}
+
+Model::Model(string const &path, GeometryBuffer &geometryBuffer,
+             TextureCache &textureCache)
+        : textureCache(&textureCache) {
+    setup(import(path), geometryBuffer);
+}
+
+Model::~Model() {
+    for (auto const texture : textures) {
+        textureCache->release(texture);
+    }
+}
+
+void Model::enqueue(RenderQueue &queue, mat4 const &world,
+                    GLuint const overrideTexture,
+                    int const level) const {
     for (auto const &mesh : meshes) {
-        mesh.render(shader0, overrideTexture);
+        mesh.enqueue(queue, *this, world, overrideTexture, level);
+    }
+}
+
+void Model::setup(ModelData const &data, GeometryBuffer &geometryBuffer) {
+    std::map<string, GLuint> textureIds;
+
+    // Cached vertices and indices go from the mapped file straight into
+    // the geometry buffer
+    for (auto const &mesh : data.meshes) {
+        vector<Texture> meshTextures;
+        for (auto const &filename : mesh.textures) {
+            if (textureIds.count(filename) == 0) {
+                textureIds[filename] = textureCache->acquire(filename);
+                textures.push_back(textureIds[filename]);
+            }
+            meshTextures.push_back({textureIds[filename], filename});
+        }
+
+        vector<GeometryRange> levels;
+        levels.push_back(geometryBuffer.add(
+                mesh.vertices, mesh.vertexCount,
+                mesh.levels[0].data, mesh.levels[0].size));
+        for (std::size_t level = 1; level < mesh.levels.size(); ++level) {
+            levels.push_back(geometryBuffer.addIndices(
+                    levels[0].baseVertex,
+                    mesh.levels[level].data, mesh.levels[level].size));
+        }
+
+        meshes.emplace_back(geometryBuffer.getVertexArray(), levels,
+                            meshTextures, mesh.bounds, mesh.boundingSphere);
     }
+
+    computeBounds();
 }
-    
-void Model::loadModel(string const &path) {
+
+void Model::loadModel(string const &path, ModelData &data) {
     Assimp::Importer importer;
 
-    aiScene const *scene = importer.ReadFile(path,
-            aiProcess_Triangulate/* | aiProcess_FlipUVs*/);
+    aiScene const *scene = importer.ReadFile(path, IMPORT_FLAGS);
 
     if(!scene ||
        scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
@@ -51,29 +118,66 @@ void Model::loadModel(string const &path) {
                 string(importer.GetErrorString())).c_str());
     }
 
-    processNode(scene->mRootNode, scene);
+    processNode(scene->mRootNode, scene, data);
+
+    // The meshes point into the imported arrays only now that no more
+    // are added
+    for (std::size_t i = 0; i < data.imported.size(); ++i) {
+        auto const &imported = data.imported[i];
+        MeshCache::Entry &mesh = data.meshes[i];
+
+        mesh.vertices = imported.vertices.data();
+        mesh.vertexCount = imported.vertices.size();
+        for (auto const &indices : imported.levels) {
+            mesh.levels.push_back({indices.data(), indices.size()});
+        }
+    }
+
+    // Including the simplified levels, so the next start can skip the
+    // import
+    MeshCache::write(path, IMPORT_FLAGS, data.meshes);
+}
+
+void Model::computeBounds() {
+    // Whole-model bounds enclose the bounds of every mesh
+    for (auto const &mesh : meshes) {
+        bounds.extend(mesh.bounds);
+    }
+    if (bounds.isEmpty()) {
+        return;
+    }
+    boundingSphere = BoundingSphere(bounds.getCenter(), 0.0f);
+    for (auto const &mesh : meshes) {
+        boundingSphere.radius = std::max(boundingSphere.radius,
+                glm::distance(boundingSphere.center,
+                              mesh.boundingSphere.center) +
+                mesh.boundingSphere.radius);
+    }
 }
 
-void Model::processNode(aiNode *node, const aiScene *scene) {
+void Model::processNode(aiNode *node, const aiScene *scene,
+                        ModelData &data) {
     if (!node) {
         return;
     }
     for(unsigned int i = 0; i < node->mNumMeshes; ++i) {
-        Mesh m = processMesh(scene->mMeshes[node->mMeshes[i]], scene);
-        if (m.vertices.size() > 0) {
-            m.setupMesh();
-            meshes.push_back(m);
-        }
+        processMesh(scene->mMeshes[node->mMeshes[i]], scene, data);
     }
     for(unsigned int i = 0; i < node->mNumChildren; ++i) {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, data);
     }
 }
 
-Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
+void Model::processMesh(aiMesh *mesh, const aiScene *scene,
+                        ModelData &data) {
+    if (mesh->mNumVertices == 0) {
+        return;
+    }
+
     vector<Vertex> vertices;
     vector<unsigned int> indices;
-    vector<Texture> textures;
+    MeshCache::Entry entry;
+    BoundingBox bounds;
 
     for(int i = 0; i < mesh->mNumVertices; ++i) {
         Vertex vertex;
@@ -95,6 +199,14 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
         }
 
         vertices.push_back(vertex);
+        bounds.extend(vertex.position);
+    }
+
+    // Sphere around the box center, just large enough for every vertex
+    BoundingSphere boundingSphere(bounds.getCenter(), 0.0f);
+    for (auto const &vertex : vertices) {
+        boundingSphere.radius = std::max(boundingSphere.radius,
+                glm::distance(boundingSphere.center, vertex.position));
     }
 
     for(int i = 0; i < mesh->mNumFaces; ++i) {
@@ -110,12 +222,18 @@ Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
         aiString path;
         material->GetTexture(aiTextureType_DIFFUSE, i, &path);
 
-        textures.push_back({
-            loadTextureFromFile(path.C_Str()), path.C_Str()
-        });
+        entry.textures.push_back(path.C_Str());
     }
 
-    return Mesh(vertices, indices, textures);
+    entry.bounds = bounds;
+    entry.boundingSphere = boundingSphere;
+    data.meshes.push_back(entry);
+
+    ModelData::ImportedMesh imported;
+    imported.levels = Mesh::simplify(vertices, indices);
+    imported.levels.insert(imported.levels.begin(), std::move(indices));
+    imported.vertices = std::move(vertices);
+    data.imported.push_back(std::move(imported));
 }
 
 // ///////////////////////////////////////////////////////////////////// //
@@ -3,7 +3,9 @@
 // //////////////////////////////////////////////////////////// Includes //
 #include "shader.hpp"
 #include "mesh.hpp"
+#include "mesh-cache.hpp"
 #include "renderable.hpp"
+#include "texture-cache.hpp"
 
 #include "assimp/scene.h"
 
@@ -11,23 +13,67 @@
 #include <vector>
 #include <memory>
 
+// /////////////////////////////////////////////////// Struct: ModelData //
+// The part of loading a model that needs no OpenGL context: the meshes
+// with all their detail levels, read from the mesh cache or imported and
+// simplified. Meshes point either into the mapped cache or into the
+// imported arrays, both owned here. Textures are left to the texture
+// cache, which decodes each file once for all models.
+struct ModelData {
+    struct ImportedMesh {
+        std::vector<Vertex> vertices;
+        // Full detail first
+        std::vector<std::vector<unsigned int>> levels;
+    };
+
+    std::vector<MeshCache::Entry> meshes;
+
+    std::unique_ptr<MeshCache> cache;
+    std::vector<ImportedMesh> imported;
+};
+
 // //////////////////////////////////////////////////////// Class: Model //
 class Model : public Renderable {
 private:
     std::vector<Mesh> meshes;
+    // One reference per distinct texture file, dropped with the model
+    TextureCache *textureCache;
+    std::vector<GLuint> textures;
 
 public:
-    Model(std::string const &path);
+    // First stage of loading: safe to run on any thread, so independent
+    // models can be imported side by side
+    static ModelData import(std::string const &path);
+
+    // Second stage, on the thread that owns the OpenGL context: uploads
+    // the meshes and takes the textures from the cache, which has to
+    // outlive the model
+    Model(ModelData const &data, GeometryBuffer &geometryBuffer,
+          TextureCache &textureCache);
 
-    void render(std::shared_ptr<Shader> shader,
-                GLuint const overrideTexture = 0) const;
+    // Both stages on the calling thread
+    Model(std::string const &path, GeometryBuffer &geometryBuffer,
+          TextureCache &textureCache);
+
+    ~Model();
+
+    Model(Model const &) = delete;
+    Model &operator=(Model const &) = delete;
+
+    void enqueue(RenderQueue &queue, glm::mat4 const &world,
+                 GLuint const overrideTexture = 0,
+                 int const level = 0) const;
     
 private:
-    void loadModel(std::string const &path);
-    void processNode(aiNode *node, const aiScene *scene);
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene);
-    std::vector<Texture> loadMaterialTextures(aiMaterial *mat,
-            aiTextureType type, std::string typeName);
+    void setup(ModelData const &data, GeometryBuffer &geometryBuffer);
+    void computeBounds();
+
+    // Imports the source file and caches the result
+    static void loadModel(std::string const &path, ModelData &data);
+    static void processNode(aiNode *node, const aiScene *scene,
+                            ModelData &data);
+    static void processMesh(aiMesh *mesh, const aiScene *scene,
+                            ModelData &data);
 };
 
 // ///////////////////////////////////////////////////////////////////// //
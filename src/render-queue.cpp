@@ -0,0 +1,217 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "render-queue.hpp"
+#include "gl-state.hpp"
+#include "renderable.hpp"
+
+#include <algorithm>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::value_ptr;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Layout glMultiDrawElementsIndirect reads
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+}
+
+// ////////////////////////////////////////////////// Class: RenderQueue //
+RenderQueue::RenderQueue(FrameArena &arena)
+        : items(ArenaAllocator<DrawItem>(arena)),
+          entries(ArenaAllocator<SortEntry>(arena)),
+          batches(ArenaAllocator<Batch>(arena)) {
+}
+
+void RenderQueue::reserve(std::size_t const count) {
+    items.reserve(count);
+    entries.reserve(count);
+}
+
+void RenderQueue::add(DrawItem const &item) {
+    entries.push_back({makeKey(item),
+                       static_cast<std::uint32_t>(items.size())});
+    items.push_back(item);
+}
+
+std::size_t RenderQueue::size() const {
+    return items.size();
+}
+
+RenderStatistics RenderQueue::submit(mat4 const &viewProjection,
+                                     InstanceBuffer &instances,
+                                     StreamBuffer &commands,
+                                     GpuCulling *const culling) {
+    RenderStatistics statistics = {0, 0, 0, 0, 0, 0};
+    if (entries.empty()) {
+        items.clear();
+        return statistics;
+    }
+
+    // Only the 16-byte entries move while sorting, the items stay put
+    std::sort(entries.begin(), entries.end(),
+              [](SortEntry const &a, SortEntry const &b) {
+                  return a.key < b.key;
+              });
+
+    // World matrices in draw order, so every run of equal items reads a
+    // contiguous range starting at its first entry. GPU culling gets
+    // the bounds as well, and the command of each instance once the
+    // commands are known.
+    mat4 *worlds = nullptr;
+    CullingInstance *cullingInstances = nullptr;
+    if (culling != nullptr) {
+        cullingInstances = culling->map(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            DrawItem const &item = items[entries[i].item];
+            BoundingSphere const &sphere = *item.boundingSphere;
+            cullingInstances[i].world = *item.world;
+            cullingInstances[i].sphere = glm::vec4(sphere.center,
+                                                   sphere.radius);
+        }
+    } else {
+        worlds = instances.map(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            worlds[i] = *items[entries[i].item].world;
+        }
+        instances.unmap();
+    }
+
+    // One command per run of items drawing the same geometry, one batch
+    // per run of commands sharing all state; there are never more
+    // commands than entries
+    auto *const commandData = static_cast<DrawElementsIndirectCommand *>(
+            commands.map(entries.size()
+                         * sizeof(DrawElementsIndirectCommand)));
+    std::uint32_t commandCount = 0;
+
+    for (std::size_t first = 0; first < entries.size();) {
+        DrawItem const &item = items[entries[first].item];
+
+        std::size_t last = first + 1;
+        while (last < entries.size()
+               && canShareCommand(item, items[entries[last].item])) {
+            ++last;
+        }
+
+        if (batches.empty()
+            || !canShareState(items[batches.back().item], item)) {
+            batches.push_back({entries[first].item, commandCount, 0});
+        }
+        ++batches.back().commandCount;
+
+        if (item.mode == GL_TRIANGLES) {
+            statistics.triangles += (last - first)
+                                    * (item.geometry.indexCount / 3);
+        }
+
+        if (cullingInstances != nullptr) {
+            for (std::size_t i = first; i < last; ++i) {
+                cullingInstances[i].command = commandCount;
+            }
+        }
+
+        // With GPU culling the instances count themselves in
+        commandData[commandCount++] = {
+                static_cast<GLuint>(item.geometry.indexCount),
+                cullingInstances != nullptr
+                        ? 0u : static_cast<GLuint>(last - first),
+                item.geometry.firstIndex,
+                item.geometry.baseVertex,
+                static_cast<GLuint>(first)};
+
+        first = last;
+    }
+    commands.unmap();
+
+    if (culling != nullptr) {
+        culling->unmap();
+        culling->cull(viewProjection, commands);
+    }
+
+    // Names no object ever has, so the first draw binds everything
+    Shader *currentShader = nullptr;
+    GLuint currentTexture = UINT32_MAX;
+    GLuint currentVertexArray = UINT32_MAX;
+
+    glstate::activeTexture(GL_TEXTURE0);
+    commands.bind();
+
+    for (auto const &batch : batches) {
+        DrawItem const &item = items[batch.item];
+        Shader &shader = *item.shader;
+
+        if (item.shader != currentShader) {
+            shader.use();
+            shader.uniform1i("texture0", 0);
+            shader.uniformMatrix4fv("viewProjection",
+                                    value_ptr(viewProjection));
+            item.renderable->setupShader(shader);
+
+            currentShader = item.shader;
+            ++statistics.programChanges;
+        }
+        if (item.texture != currentTexture) {
+            glstate::bindTexture(GL_TEXTURE_2D, item.texture);
+            currentTexture = item.texture;
+            ++statistics.textureChanges;
+        }
+        if (item.vao != currentVertexArray) {
+            glstate::bindVertexArray(item.vao);
+            if (culling != nullptr) {
+                culling->bind();
+            } else {
+                instances.bind();
+            }
+            currentVertexArray = item.vao;
+            ++statistics.vertexArrayChanges;
+        }
+
+        std::uintptr_t const offset =
+                batch.firstCommand * sizeof(DrawElementsIndirectCommand);
+        glMultiDrawElementsIndirect(item.mode, GL_UNSIGNED_INT,
+                                    reinterpret_cast<void const *>(offset),
+                                    static_cast<GLsizei>(batch.commandCount),
+                                    0);
+        ++statistics.drawCalls;
+        statistics.drawCommands += batch.commandCount;
+    }
+
+    items.clear();
+    entries.clear();
+    batches.clear();
+    return statistics;
+}
+
+std::uint64_t RenderQueue::makeKey(DrawItem const &item) {
+    // Program changes cost the most, so they get the top bits; the GL
+    // names are small integers and fit comfortably. Geometry comes last,
+    // so items drawing the same mesh end up next to each other.
+    std::uint64_t const program = item.shader->getProgram() & 0xFFFu;
+    std::uint64_t const texture = item.texture & 0xFFFFu;
+    std::uint64_t const vertexArray = item.vao & 0xFFu;
+    std::uint64_t const geometry = item.geometry.firstIndex & 0xFFFFFFFu;
+
+    return (program << 52) | (texture << 36) | (vertexArray << 28)
+           | geometry;
+}
+
+bool RenderQueue::canShareState(DrawItem const &a, DrawItem const &b) {
+    // Compared in full - the key truncates the names
+    return a.shader == b.shader && a.texture == b.texture
+           && a.vao == b.vao && a.mode == b.mode;
+}
+
+bool RenderQueue::canShareCommand(DrawItem const &a, DrawItem const &b) {
+    return canShareState(a, b)
+           && a.geometry.firstIndex == b.geometry.firstIndex
+           && a.geometry.baseVertex == b.geometry.baseVertex
+           && a.geometry.indexCount == b.geometry.indexCount;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
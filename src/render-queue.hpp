@@ -0,0 +1,100 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+#include "frame-arena.hpp"
+#include "geometry-buffer.hpp"
+#include "gpu-culling.hpp"
+#include "instance-buffer.hpp"
+#include "opengl-headers.hpp"
+#include "shader.hpp"
+#include "stream-buffer.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+class Renderable;
+
+// //////////////////////////////////////////////////// Struct: DrawItem //
+// One object to draw. Items that only differ in their world matrix are
+// drawn together as instances.
+struct DrawItem {
+    // Gets a chance to set per-program uniforms when its shader is bound
+    Renderable const *renderable;
+    Shader *shader;
+    glm::mat4 const *world;
+    // Model-space bounds, for culling on the GPU
+    BoundingSphere const *boundingSphere;
+
+    GLuint texture;
+    // Vertex array of the geometry buffer holding the mesh
+    GLuint vao;
+    GLenum mode;
+    GeometryRange geometry;
+};
+
+// //////////////////////////////////////////// Struct: RenderStatistics //
+struct RenderStatistics {
+    // Multi-draw calls, and the indirect commands they issued
+    std::size_t drawCalls;
+    std::size_t drawCommands;
+    std::size_t programChanges;
+    std::size_t textureChanges;
+    std::size_t vertexArrayChanges;
+    // Of every instance submitted, before any culling on the GPU
+    std::size_t triangles;
+};
+
+// ////////////////////////////////////////////////// Class: RenderQueue //
+// Per-frame list of draw items. Each item gets a 64-bit key - program in
+// the top bits, then texture, vertex array and geometry - and submit()
+// sorts the keys and issues the draws in one pass, binding state only
+// when it differs from the previous draw. Runs of items sharing the
+// geometry become one instanced indirect command, with the world
+// matrices streamed to the instance buffer in sorted order; all commands
+// sharing program, texture and vertex array go out in a single
+// glMultiDrawElementsIndirect. Items live in the frame arena.
+//
+// With GPU culling the items are not culled beforehand: every instance
+// goes to the compute shader along with its bounds, and the commands
+// start out empty for the shader to fill.
+class RenderQueue {
+public:
+    explicit RenderQueue(FrameArena &arena);
+
+    void reserve(std::size_t count);
+    void add(DrawItem const &item);
+    std::size_t size() const;
+
+    // The instance buffer goes unused when culling is given
+    RenderStatistics submit(glm::mat4 const &viewProjection,
+                            InstanceBuffer &instances,
+                            StreamBuffer &commands,
+                            GpuCulling *culling = nullptr);
+
+private:
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t item;
+    };
+
+    // Commands sharing all state, drawn by one multi-draw call
+    struct Batch {
+        std::uint32_t item;
+        std::uint32_t firstCommand;
+        std::uint32_t commandCount;
+    };
+
+    FrameVector<DrawItem> items;
+    FrameVector<SortEntry> entries;
+    FrameVector<Batch> batches;
+
+    static std::uint64_t makeKey(DrawItem const &item);
+    static bool canShareState(DrawItem const &a, DrawItem const &b);
+    static bool canShareCommand(DrawItem const &a, DrawItem const &b);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // RENDER_QUEUE_H
@@ -2,16 +2,44 @@
 #define RENDERABLE_H
 
 #include <memory>
+#include "bounds.hpp"
+#include "handle-pool.hpp"
 #include "opengl-headers.hpp"
+#include "render-queue.hpp"
 #include "shader.hpp"
 
 class Renderable {
 public:
+    // Detail levels a renderable may offer; level k aims at 2^-k of the
+    // full triangle count
+    static constexpr int LEVEL_COUNT = 4;
+
     std::shared_ptr<Shader> shader;
 
-    virtual void render(std::shared_ptr<Shader> shader,
-                        GLuint const overrideTexture) const = 0;
+    // Model-space bounds, used to cull the renderable's scene nodes
+    BoundingBox bounds;
+    BoundingSphere boundingSphere;
+
+    // Adds the draw items for one instance placed at world; level 0 is
+    // full detail, renderables with fewer levels use their coarsest
+    virtual void enqueue(RenderQueue &queue, glm::mat4 const &world,
+                         GLuint const overrideTexture,
+                         int const level) const = 0;
+
+    // Called whenever the queue switches to this renderable's shader;
+    // renderables sharing a shader have to agree on what is set here
+    virtual void setupShader(Shader &) const {}
     virtual ~Renderable() {}
 };
 
+// The pool holds owning pointers, not the renderables themselves: they
+// are polymorphic and of very different sizes (a model owns its mesh
+// list, a sphere a handful of ranges), and a slot's renderable may be
+// swapped for another type, e.g. a placeholder for the loaded model. So
+// each renderable is still one heap allocation. That is acceptable
+// because there are only a few of them. Scene nodes, of which there are
+// many, refer to them by handle and need no allocation of their own.
+using RenderablePool = HandlePool<std::unique_ptr<Renderable>>;
+using RenderableHandle = RenderablePool::Handle;
+
 #endif // RENDERABLE_H
@@ -0,0 +1,284 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "resource-manager.hpp"
+#include "gl-state.hpp"
+
+#include <chrono>
+#include <utility>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using loadclock = std::chrono::steady_clock;
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+using glm::mat4;
+using glm::vec2;
+using glm::vec3;
+
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    std::size_t getUploadSize(Image const &image) {
+        return static_cast<std::size_t>(image.width) * image.height
+               * image.channels;
+    }
+
+    std::size_t getUploadSize(ModelData const &data) {
+        std::size_t size = 0;
+        for (auto const &mesh : data.meshes) {
+            size += mesh.vertexCount * sizeof(Vertex);
+            for (auto const &level : mesh.levels) {
+                size += level.size * sizeof(unsigned int);
+            }
+        }
+        return size;
+    }
+
+    // ////////////////////////////////////////// Class: PlaceholderModel //
+    // Unit box standing in for a model that is still loading
+    class PlaceholderModel : public Renderable {
+    public:
+        PlaceholderModel(GLuint const vao, GeometryRange const &box,
+                         GLuint const texture)
+                : vao(vao),
+                  box(box),
+                  texture(texture) {
+            bounds = BoundingBox(vec3(-0.5f), vec3(0.5f));
+            boundingSphere = BoundingSphere(vec3(0.0f),
+                                            glm::length(vec3(0.5f)));
+        }
+
+        void enqueue(RenderQueue &queue, mat4 const &world,
+                     GLuint const overrideTexture, int) const {
+            DrawItem item;
+            item.renderable = this;
+            item.shader = shader.get();
+            item.world = &world;
+            item.boundingSphere = &boundingSphere;
+            item.texture = overrideTexture != 0 ? overrideTexture
+                                                : texture;
+            item.vao = vao;
+            item.mode = GL_TRIANGLES;
+            item.geometry = box;
+
+            queue.add(item);
+        }
+
+    private:
+        GLuint vao;
+        GeometryRange box;
+        GLuint texture;
+    };
+}
+
+// ////////////////////////////////////////////// Class: ResourceManager //
+std::size_t const ResourceManager::UPLOAD_BUDGET;
+std::size_t const ResourceManager::RESULT_QUEUE_CAPACITY;
+
+ResourceManager::Result::Result()
+        : size(0),
+          decodeMilliseconds(0.0) {
+}
+
+ResourceManager::ResourceManager(TaskScheduler &scheduler,
+                                 RenderablePool &renderables, Scene &scene,
+                                 GeometryBuffer &geometryBuffer)
+        : scheduler(scheduler),
+          renderables(renderables),
+          scene(scene),
+          geometryBuffer(geometryBuffer),
+          textures([this](string const &path) {
+              start([path]() {
+                  auto const startTime = loadclock::now();
+
+                  Result result;
+                  result.texturePath = path;
+                  result.image = loadImage(path);
+                  result.size = getUploadSize(result.image);
+                  result.decodeMilliseconds =
+                          milliseconds(loadclock::now() - startTime).count();
+                  return result;
+              });
+          }),
+          runningCount(0),
+          stopping(false),
+          pendingCount(0) {
+    glGenTextures(1, &placeholderTexture);
+    uploadPlaceholder(placeholderTexture);
+
+    vector<Vertex> vertices;
+    for (int corner = 0; corner < 8; ++corner) {
+        vec3 const side(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+        Vertex vertex;
+        vertex.position = side - vec3(0.5f);
+        vertex.texCoords = vec2(side.x, side.y);
+        vertices.push_back(vertex);
+    }
+    placeholderBox = geometryBuffer.add(vertices, {
+            0, 2, 1,  1, 2, 3,  4, 5, 6,  5, 7, 6,
+            0, 1, 4,  1, 5, 4,  2, 6, 3,  3, 6, 7,
+            0, 4, 2,  2, 4, 6,  1, 3, 5,  3, 7, 5});
+}
+
+ResourceManager::~ResourceManager() {
+    // Submitted loads still run, or at least start, on the scheduler;
+    // run() skips them once stopping is set
+    unique_lock<mutex> lock(queueMutex);
+    stopping = true;
+    idleCondition.wait(lock, [this]() {
+        return runningCount == 0;
+    });
+    lock.unlock();
+
+    glstate::deleteTexture(placeholderTexture);
+}
+
+GLuint ResourceManager::loadTexture(string const &path) {
+    return textures.acquire(path);
+}
+
+RenderableHandle ResourceManager::loadModel(
+        string const &path, shared_ptr<Shader> const &shader) {
+    unique_ptr<Renderable> placeholder = make_unique<PlaceholderModel>(
+            geometryBuffer.getVertexArray(), placeholderBox,
+            placeholderTexture);
+    placeholder->shader = shader;
+    RenderableHandle const model = renderables.create(std::move(placeholder));
+
+    start([path, model, shader]() {
+        Result result;
+        result.model = model;
+        result.shader = shader;
+        result.modelData = make_unique<ModelData>(Model::import(path));
+        result.size = getUploadSize(*result.modelData);
+        return result;
+    });
+    return model;
+}
+
+void ResourceManager::update() {
+    std::size_t uploaded = 0;
+
+    while (uploaded < UPLOAD_BUDGET) {
+        Result result;
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (results.empty()) {
+                break;
+            }
+            result = std::move(results.front());
+            results.pop_front();
+        }
+
+        --pendingCount;
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+
+        apply(result);
+        uploaded += result.size;
+    }
+
+    dispatch();
+}
+
+std::size_t ResourceManager::getPendingCount() const {
+    return pendingCount;
+}
+
+TextureCache::Statistics ResourceManager::getTextureStatistics() const {
+    return textures.getStatistics();
+}
+
+vector<ResourceManager::TextureTiming> const &
+ResourceManager::getTextureTimings() const {
+    return textureTimings;
+}
+
+void ResourceManager::start(std::function<Result()> request) {
+    requests.push_back(std::move(request));
+    ++pendingCount;
+    dispatch();
+}
+
+void ResourceManager::dispatch() {
+    // Taken under the lock, submitted after it: without workers the
+    // scheduler runs a function at once, and run() locks the queue too
+    vector<std::function<Result()>> batch;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        while (!requests.empty()
+               && runningCount + results.size() < RESULT_QUEUE_CAPACITY) {
+            batch.push_back(std::move(requests.front()));
+            requests.pop_front();
+            ++runningCount;
+        }
+    }
+
+    for (auto &request : batch) {
+        std::function<Result()> const function = std::move(request);
+        scheduler.submitBackground([this, function]() {
+            run(function);
+        });
+    }
+}
+
+void ResourceManager::run(std::function<Result()> const &request) {
+    bool skip;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        skip = stopping;
+    }
+
+    Result result;
+    if (!skip) {
+        try {
+            result = request();
+        } catch (...) {
+            result.error = std::current_exception();
+        }
+    }
+
+    // A result finished during shutdown is dropped. Notified under the
+    // lock: once the count is zero the destructor may go ahead at once
+    lock_guard<mutex> lock(queueMutex);
+    if (!stopping) {
+        results.push_back(std::move(result));
+    }
+    --runningCount;
+    idleCondition.notify_all();
+}
+
+void ResourceManager::apply(Result &result) {
+    if (!result.model.isValid()) {
+        auto const startTime = loadclock::now();
+        if (textures.upload(result.texturePath, result.image)) {
+            textureTimings.push_back({
+                    result.texturePath, result.decodeMilliseconds,
+                    milliseconds(loadclock::now() - startTime).count()});
+        }
+        return;
+    }
+
+    // The handle stays, only what it refers to changes; a model released
+    // while it was loading is dropped
+    unique_ptr<Renderable> *const slot = renderables.get(result.model);
+    if (slot == nullptr) {
+        return;
+    }
+
+    unique_ptr<Renderable> model =
+            make_unique<Model>(*result.modelData, geometryBuffer, textures);
+    model->shader = result.shader;
+    *slot = std::move(model);
+
+    scene.refreshBounds(result.model);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
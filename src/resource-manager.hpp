@@ -0,0 +1,128 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "geometry-buffer.hpp"
+#include "image.hpp"
+#include "model.hpp"
+#include "renderable.hpp"
+#include "scene.hpp"
+#include "shader.hpp"
+#include "task-scheduler.hpp"
+#include "texture-cache.hpp"
+
+#include "opengl-headers.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ////////////////////////////////////////////// Class: ResourceManager //
+// Loads models and textures in the background, on the task scheduler's
+// background queue, which the frame thread never drains. The scheduler
+// has to outlive the manager.
+//
+// Requests return at once. A texture is a real texture name that shows a
+// grey placeholder until its image is decoded; a model is a renderable
+// handle that draws a placeholder box until its import is done. Textures,
+// including those of the models, go through a texture cache, so a file
+// is decoded and uploaded once however many times it is asked for.
+// update(), called once per frame on the context thread, swaps finished
+// resources in place - names and handles stay the same - and refreshes
+// the scene's bounds for the models that changed. It uploads at most
+// UPLOAD_BUDGET bytes per frame, and always at least one resource, so a
+// large scene streams in over several frames instead of stalling one of
+// them. At most RESULT_QUEUE_CAPACITY loads are running or waiting for it
+// at a time; the rest stay queued here, so decoded images never pile up
+// in memory faster than they are uploaded.
+//
+// The models keep references to the texture cache, so release the
+// renderables before the manager.
+class ResourceManager {
+public:
+    // Time a texture spent on each side of the queue
+    struct TextureTiming {
+        std::string path;
+        // On a worker thread
+        double decodeMilliseconds;
+        // On the context thread; what the driver defers is not counted
+        double uploadMilliseconds;
+    };
+
+    ResourceManager(TaskScheduler &scheduler, RenderablePool &renderables,
+                    Scene &scene, GeometryBuffer &geometryBuffer);
+    // Waits for the loads in progress; queued ones are dropped
+    ~ResourceManager();
+
+    ResourceManager(ResourceManager const &) = delete;
+    ResourceManager &operator=(ResourceManager const &) = delete;
+
+    GLuint loadTexture(std::string const &path);
+    RenderableHandle loadModel(std::string const &path,
+                               std::shared_ptr<Shader> const &shader);
+
+    // Swaps in what finished loading; rethrows the first exception a
+    // load threw
+    void update();
+
+    // Requested and not yet swapped in
+    std::size_t getPendingCount() const;
+
+    TextureCache::Statistics getTextureStatistics() const;
+
+    // In upload order
+    std::vector<TextureTiming> const &getTextureTimings() const;
+
+private:
+    static std::size_t const UPLOAD_BUDGET = 16 * 1024 * 1024;
+    static std::size_t const RESULT_QUEUE_CAPACITY = 8;
+
+    // A finished load, waiting for update()
+    struct Result {
+        Result();
+
+        std::string texturePath;
+        Image image;
+        RenderableHandle model;
+        std::unique_ptr<ModelData> modelData;
+        std::shared_ptr<Shader> shader;
+        std::exception_ptr error;
+        std::size_t size;
+        double decodeMilliseconds;
+    };
+
+    TaskScheduler &scheduler;
+    RenderablePool &renderables;
+    Scene &scene;
+    GeometryBuffer &geometryBuffer;
+
+    TextureCache textures;
+    GLuint placeholderTexture;
+    GeometryRange placeholderBox;
+
+    std::mutex queueMutex;
+    std::condition_variable idleCondition;
+    std::deque<Result> results;
+    // Submitted to the scheduler and not yet in results
+    std::size_t runningCount;
+    bool stopping;
+
+    // Owned by the context thread only
+    std::deque<std::function<Result()>> requests;
+    std::size_t pendingCount;
+    std::vector<TextureTiming> textureTimings;
+
+    void start(std::function<Result()> request);
+    // Submits queued requests while there is room for their results
+    void dispatch();
+    void run(std::function<Result()> const &request);
+    void apply(Result &result);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // RESOURCE_MANAGER_H
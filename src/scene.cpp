@@ -0,0 +1,405 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "scene.hpp"
+#include "detail-level.hpp"
+
+#include "glm/gtc/matrix_access.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::vec3;
+using glm::vec4;
+
+using std::exception;
+using std::vector;
+
+// //////////////////////////////////////////////////////// Class: Scene //
+std::size_t const Scene::BOUNDS_GRAIN_SIZE;
+float constexpr Scene::REBUILD_COST_RATIO;
+
+Scene::Scene(RenderablePool &renderables)
+        : renderables(renderables),
+          levelOfDetail(true) {
+    clear();
+}
+
+Scene::Node Scene::getRoot() const {
+    return root;
+}
+
+Scene::Node Scene::addNode(Node const parent,
+                           RenderableHandle const model,
+                           GLuint const overrideTexture) {
+    Index const parentIndex = parent.isValid()
+                              ? getIndex(parent)
+                              : TransformHierarchy::NO_PARENT;
+    Index const index = hierarchy.add(parentIndex);
+
+    if (index == models.size()) {
+        models.push_back(model);
+        overrideTextures.push_back(overrideTexture);
+        worldBounds.emplace_back();
+        worldSpheres.emplace_back();
+        levels.push_back(0);
+        handles.emplace_back();
+        proxies.push_back(AabbTree::NONE);
+        firstChildren.push_back(TransformHierarchy::NO_PARENT);
+        nextSiblings.push_back(TransformHierarchy::NO_PARENT);
+        subtreeBounds.emplace_back();
+        refitQueued.push_back(0);
+    } else {
+        models[index] = model;
+        overrideTextures[index] = overrideTexture;
+        levels[index] = 0;
+    }
+
+    // The node is new to the hierarchy, so it shows up as changed on the
+    // next update and its parent's subtree box is refit then
+    if (parentIndex != TransformHierarchy::NO_PARENT) {
+        nextSiblings[index] = firstChildren[parentIndex];
+        firstChildren[parentIndex] = index;
+    } else {
+        nextSiblings[index] = TransformHierarchy::NO_PARENT;
+    }
+
+    handles[index] = nodes.create(index);
+    return handles[index];
+}
+
+void Scene::removeNode(Node const node) {
+    Index const index = getIndex(node);
+    Index const parent = hierarchy.getParent(index);
+
+    hierarchy.remove(index);
+
+    // Only leaves can go, so there are no children to unlink
+    if (parent != TransformHierarchy::NO_PARENT) {
+        Index *link = &firstChildren[parent];
+        while (*link != index) {
+            link = &nextSiblings[*link];
+        }
+        *link = nextSiblings[index];
+
+        // The parent's subtree box may shrink now
+        queueRefit(parent);
+    }
+
+    if (proxies[index] != AabbTree::NONE) {
+        tree.remove(proxies[index]);
+        proxies[index] = AabbTree::NONE;
+    }
+
+    models[index] = RenderableHandle();
+    overrideTextures[index] = 0;
+    worldBounds[index] = BoundingBox();
+    worldSpheres[index] = BoundingSphere();
+    levels[index] = 0;
+    handles[index] = Node();
+    subtreeBounds[index] = BoundingBox();
+
+    nodes.destroy(node);
+}
+
+bool Scene::contains(Node const node) const {
+    return nodes.contains(node);
+}
+
+void Scene::setTransform(Node const node, Transform const &transform) {
+    hierarchy.setLocal(getIndex(node), transform);
+}
+
+Transform const &Scene::getTransform(Node const node) const {
+    return hierarchy.getLocal(getIndex(node));
+}
+
+mat4 const &Scene::getWorldTransform(Node const node) const {
+    return hierarchy.getWorld(getIndex(node));
+}
+
+BoundingBox const &Scene::getWorldBounds(Node const node) const {
+    return worldBounds[getIndex(node)];
+}
+
+BoundingBox const &Scene::getSubtreeBounds(Node const node) const {
+    return subtreeBounds[getIndex(node)];
+}
+
+Scene::Node Scene::pick(vec3 const &origin, vec3 const &direction) const {
+    AabbTree::RayHit const hit = tree.raycast(
+            origin, direction, std::numeric_limits<float>::max(),
+            [this, &origin, &direction](std::uint32_t const index,
+                                        float) {
+                float distance;
+                return worldBounds[index].intersectsRay(origin, direction,
+                                                        distance)
+                       ? distance : -1.0f;
+            });
+
+    return hit.userData != AabbTree::NONE ? handles[hit.userData] : Node();
+}
+
+void Scene::update(TaskScheduler *const scheduler) {
+    hierarchy.update(scheduler);
+
+    // Only nodes whose world matrix moved need new bounds
+    std::size_t const count = hierarchy.getChanged().size();
+
+    if (scheduler != nullptr) {
+        scheduler->parallelFor(0, count, BOUNDS_GRAIN_SIZE,
+                               [this](std::size_t const first,
+                                      std::size_t const last) {
+                                   updateBounds(first, last);
+                               });
+    } else {
+        updateBounds(0, count);
+    }
+
+    for (Index const index : hierarchy.getChanged()) {
+        queueRefit(index);
+    }
+    refitSubtreeBounds();
+
+    updateTree();
+}
+
+void Scene::refreshBounds(RenderableHandle const model) {
+    if (!model.isValid()) {
+        return;
+    }
+
+    for (Index index = 0; index < models.size(); ++index) {
+        if (models[index] == model) {
+            computeBounds(index);
+            updateProxy(index);
+            queueRefit(index);
+        }
+    }
+    tree.refit();
+    refitSubtreeBounds();
+}
+
+void Scene::updateBounds(std::size_t const begin, std::size_t const end) {
+    vector<Index> const &changed = hierarchy.getChanged();
+    for (std::size_t i = begin; i < end; ++i) {
+        computeBounds(changed[i]);
+    }
+}
+
+void Scene::updateTree() {
+    for (Index const index : hierarchy.getChanged()) {
+        updateProxy(index);
+    }
+    tree.refit();
+
+    // The first update after set-up gets here too, so the static content
+    // starts out in an SAH-built tree
+    if (tree.getCost() > REBUILD_COST_RATIO * tree.getCostAfterRebuild()) {
+        tree.rebuild();
+    }
+}
+
+void Scene::queueRefit(Index const index) {
+    if (!refitQueued[index]) {
+        refitQueued[index] = 1;
+        refitQueue.push_back(index);
+        std::push_heap(refitQueue.begin(), refitQueue.end());
+    }
+}
+
+void Scene::refitSubtreeBounds() {
+    // Highest index first, so every child is done before its parent; a
+    // box that did not change leaves the parent alone, which limits the
+    // work to the paths above actual changes
+    while (!refitQueue.empty()) {
+        std::pop_heap(refitQueue.begin(), refitQueue.end());
+        Index const index = refitQueue.back();
+        refitQueue.pop_back();
+        refitQueued[index] = 0;
+
+        Index const parent = hierarchy.getParent(index);
+        if (parent == TransformHierarchy::REMOVED) {
+            continue;
+        }
+
+        BoundingBox bounds = worldBounds[index];
+        for (Index child = firstChildren[index];
+             child != TransformHierarchy::NO_PARENT;
+             child = nextSiblings[child]) {
+            bounds.extend(subtreeBounds[child]);
+        }
+
+        BoundingBox &current = subtreeBounds[index];
+        if (bounds.min == current.min && bounds.max == current.max) {
+            continue;
+        }
+        current = bounds;
+
+        if (parent != TransformHierarchy::NO_PARENT) {
+            queueRefit(parent);
+        }
+    }
+}
+
+void Scene::computeBounds(Index const index) {
+    mat4 const &world = hierarchy.getWorld(index);
+
+    auto const *model = renderables.get(models[index]);
+    if (model != nullptr) {
+        worldBounds[index] = (*model)->bounds.transformed(world);
+        worldSpheres[index] = (*model)->boundingSphere.transformed(world);
+    } else {
+        worldBounds[index] = BoundingBox();
+        worldSpheres[index] = BoundingSphere();
+    }
+}
+
+void Scene::updateProxy(Index const index) {
+    AabbTree::Proxy &proxy = proxies[index];
+    if (worldBounds[index].isEmpty()) {
+        if (proxy != AabbTree::NONE) {
+            tree.remove(proxy);
+            proxy = AabbTree::NONE;
+        }
+    } else if (proxy == AabbTree::NONE) {
+        proxy = tree.insert(worldBounds[index], index);
+    } else {
+        tree.update(proxy, worldBounds[index]);
+    }
+}
+
+std::size_t Scene::enqueue(mat4 const &viewProjection,
+                           RenderQueue &queue) {
+    auto const &worlds = hierarchy.getWorldTransforms();
+    Frustum const frustum(viewProjection);
+    std::size_t visibleCount = 0;
+
+    // Clip-space w is the view depth, and for a rigid view the length of
+    // the second row's rotation part is the vertical projection scale
+    vec4 const depthRow = glm::row(viewProjection, 3);
+    float const projectionScale =
+            glm::length(vec3(glm::row(viewProjection, 1)));
+
+    // The tree rejects whole regions of the scene; nodes it reports are
+    // tested once more against their own bounds - the sphere test is the
+    // cheap one, the box is tighter. Stale renderable handles simply drop
+    // out.
+    queue.reserve(queue.size() + tree.size());
+
+    tree.queryFrustum(frustum, [&](std::uint32_t const index) {
+        if (!frustum.intersects(worldSpheres[index]) ||
+            !frustum.intersects(worldBounds[index])) {
+            return;
+        }
+
+        auto const *model = renderables.get(models[index]);
+        if (model != nullptr) {
+            (*model)->enqueue(queue, worlds[index], overrideTextures[index],
+                              selectLevel(index, depthRow,
+                                          projectionScale));
+            ++visibleCount;
+        }
+    });
+
+    return visibleCount;
+}
+
+std::size_t Scene::enqueueAll(mat4 const &viewProjection,
+                              RenderQueue &queue) {
+    auto const &worlds = hierarchy.getWorldTransforms();
+    Frustum const frustum(viewProjection);
+    std::size_t drawableCount = 0;
+
+    vec4 const depthRow = glm::row(viewProjection, 3);
+    float const projectionScale =
+            glm::length(vec3(glm::row(viewProjection, 1)));
+
+    // Drawable nodes are exactly the ones in the tree
+    queue.reserve(queue.size() + tree.size());
+
+    // Walk down from the root, dropping every branch whose subtree box is
+    // outside the frustum; what is left is culled node by node on the GPU
+    branchStack.clear();
+    branchStack.push_back(getIndex(root));
+    while (!branchStack.empty()) {
+        Index const index = branchStack.back();
+        branchStack.pop_back();
+
+        if (!frustum.intersects(subtreeBounds[index])) {
+            continue;
+        }
+        for (Index child = firstChildren[index];
+             child != TransformHierarchy::NO_PARENT;
+             child = nextSiblings[child]) {
+            branchStack.push_back(child);
+        }
+
+        if (proxies[index] == AabbTree::NONE) {
+            continue;
+        }
+
+        auto const *model = renderables.get(models[index]);
+        if (model != nullptr) {
+            (*model)->enqueue(queue, worlds[index], overrideTextures[index],
+                              selectLevel(index, depthRow,
+                                          projectionScale));
+            ++drawableCount;
+        }
+    }
+
+    return drawableCount;
+}
+
+void Scene::setLevelOfDetail(bool const enabled) {
+    levelOfDetail = enabled;
+}
+
+void Scene::clear() {
+    nodes.clear();
+    hierarchy = TransformHierarchy();
+    models.clear();
+    overrideTextures.clear();
+    worldBounds.clear();
+    worldSpheres.clear();
+    levels.clear();
+    handles.clear();
+    tree.clear();
+    proxies.clear();
+    firstChildren.clear();
+    nextSiblings.clear();
+    subtreeBounds.clear();
+    refitQueue.clear();
+    refitQueued.clear();
+
+    root = addNode(Node());
+}
+
+int Scene::selectLevel(Index const index, vec4 const &depthRow,
+                       float const projectionScale) {
+    std::uint8_t &level = levels[index];
+    BoundingSphere const &sphere = worldSpheres[index];
+    float const depth = glm::dot(depthRow, vec4(sphere.center, 1.0f));
+
+    if (!levelOfDetail || depth <= sphere.radius) {
+        level = 0;
+        return level;
+    }
+
+    level = static_cast<std::uint8_t>(selectDetailLevel(
+            sphere.radius * projectionScale / depth, level,
+            Renderable::LEVEL_COUNT));
+    return level;
+}
+
+Scene::Index Scene::getIndex(Node const node) const {
+    Index const *index = nodes.get(node);
+    if (index == nullptr) {
+        throw exception("Stale scene node handle!");
+    }
+    return *index;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
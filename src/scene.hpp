@@ -0,0 +1,139 @@
+#ifndef SCENE_H
+#define SCENE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "aabb-tree.hpp"
+#include "bounds.hpp"
+#include "handle-pool.hpp"
+#include "opengl-headers.hpp"
+#include "render-queue.hpp"
+#include "renderable.hpp"
+#include "task-scheduler.hpp"
+#include "transform-hierarchy.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// //////////////////////////////////////////////////////// Class: Scene //
+// Scene built once at start-up. Nodes are referred to by generational
+// handles resolving to slots in flat arrays: the transform hierarchy plus
+// one renderable handle, override texture and world-space bounds per
+// slot. Drawable nodes are also leaves of a dynamic AABB tree, refit on
+// update() for the nodes that moved; frustum culling and picking both
+// query the tree instead of walking the hierarchy.
+//
+// Every node also has a box around its whole subtree, refit on update()
+// only along the paths above the nodes that moved. The AABB tree groups
+// nodes by where they are, these boxes by what moves together: when the
+// GPU culls, enqueueAll() still drops a branch outside the view frustum,
+// e.g. an orbit with everything on it, with a single test.
+//
+// Every node drawn also gets a detail level from the share of the screen
+// height its bounding sphere covers, see selectDetailLevel(); the level
+// it was last drawn at is kept per node, so it does not flicker between
+// two.
+class Scene {
+public:
+    using Node = PoolHandle<TransformHierarchy::Index>;
+
+    explicit Scene(RenderablePool &renderables);
+
+    Node getRoot() const;
+
+    Node addNode(Node parent,
+                 RenderableHandle model = RenderableHandle(),
+                 GLuint overrideTexture = 0);
+    void removeNode(Node node);
+    bool contains(Node node) const;
+
+    void setTransform(Node node, Transform const &transform);
+    Transform const &getTransform(Node node) const;
+    glm::mat4 const &getWorldTransform(Node node) const;
+    BoundingBox const &getWorldBounds(Node node) const;
+    // Around the node and all of its descendants
+    BoundingBox const &getSubtreeBounds(Node node) const;
+
+    // Closest drawable node whose world box the ray hits, or an invalid
+    // handle
+    Node pick(glm::vec3 const &origin, glm::vec3 const &direction) const;
+
+    void update(TaskScheduler *scheduler = nullptr);
+
+    // Bounds are taken from the renderables when nodes move; after a
+    // renderable's own bounds changed, e.g. when a streamed model replaced
+    // its placeholder, the nodes drawing it need them again
+    void refreshBounds(RenderableHandle model);
+
+    // Adds draw items for the nodes inside the view frustum and returns
+    // how many nodes that was
+    std::size_t enqueue(glm::mat4 const &viewProjection,
+                        RenderQueue &queue);
+    // Adds draw items for every drawable node in a branch whose subtree
+    // box is inside the view frustum, leaving the rest of the culling to
+    // the GPU, and returns how many nodes that was
+    std::size_t enqueueAll(glm::mat4 const &viewProjection,
+                           RenderQueue &queue);
+
+    // With detail levels off every node is drawn at full detail
+    void setLevelOfDetail(bool enabled);
+
+    void clear();
+
+private:
+    using Index = TransformHierarchy::Index;
+
+    RenderablePool &renderables;
+
+    HandlePool<Index> nodes;
+    Node root;
+
+    TransformHierarchy hierarchy;
+    std::vector<RenderableHandle> models;
+    std::vector<GLuint> overrideTextures;
+    std::vector<BoundingBox> worldBounds;
+    std::vector<BoundingSphere> worldSpheres;
+    // Detail level each node was last drawn at
+    std::vector<std::uint8_t> levels;
+
+    std::vector<Node> handles;
+
+    // Children as intrusive singly linked lists, for top-down traversal
+    std::vector<Index> firstChildren;
+    std::vector<Index> nextSiblings;
+    std::vector<Index> branchStack;
+
+    // Nodes whose subtree box is out of date, as a max-heap: children
+    // come after their parents, so a node is only refit once all of its
+    // children are
+    std::vector<BoundingBox> subtreeBounds;
+    std::vector<Index> refitQueue;
+    std::vector<std::uint8_t> refitQueued;
+
+    AabbTree tree;
+    std::vector<AabbTree::Proxy> proxies;
+
+    // Nodes updated together when bounds are refreshed in parallel
+    static std::size_t const BOUNDS_GRAIN_SIZE = 2048;
+    // Refits only ever loosen the tree; once its cost has grown this much
+    // since the last SAH build, it is rebuilt
+    static float constexpr REBUILD_COST_RATIO = 2.0f;
+
+    bool levelOfDetail;
+
+    // begin and end index the hierarchy's list of changed nodes
+    void updateBounds(std::size_t begin, std::size_t end);
+    void updateTree();
+    void queueRefit(Index index);
+    void refitSubtreeBounds();
+    void computeBounds(Index index);
+    void updateProxy(Index index);
+
+    // depthRow and projectionScale come from the view-projection matrix,
+    // see enqueue()
+    int selectLevel(Index index, glm::vec4 const &depthRow,
+                    float projectionScale);
+
+    Index getIndex(Node node) const;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // SCENE_H
@@ -1,5 +1,6 @@
 // //////////////////////////////////////////////////////////// Includes //
 #include "shader.hpp"
+#include "gl-state.hpp"
 #include "opengl-headers.hpp"
 
 #include <fstream>
@@ -97,6 +98,34 @@ int link(int const vertex,
     return shader;
 }
 
+int link(int const vertex,
+         int const tessellationControl,
+         int const tessellationEvaluation,
+         int const fragment) {
+    int shader = glCreateProgram();
+
+    glAttachShader(shader, vertex);
+    glAttachShader(shader, tessellationControl);
+    glAttachShader(shader, tessellationEvaluation);
+    glAttachShader(shader, fragment);
+
+    glLinkProgram(shader);
+    checkForLinkingErrors(shader);
+
+    return shader;
+}
+
+int link(int const compute) {
+    int shader = glCreateProgram();
+
+    glAttachShader(shader, compute);
+
+    glLinkProgram(shader);
+    checkForLinkingErrors(shader);
+
+    return shader;
+}
+
 // /////////////////////////////////////////////////////// Class: Shader //
 // ==================================================== Public interface ==
 // ----------------------------------------------------------- Behaviour --
@@ -122,30 +151,92 @@ Shader::Shader(string const &vertexShaderFilename,
       }()) {
 }
 
+Shader::Shader(string const &vertexShaderFilename,
+               string const &tessellationControlShaderFilename,
+               string const &tessellationEvaluationShaderFilename,
+               string const &fragmentShaderFilename)
+    : shader([&]() -> int {
+          int const vertex = glCreateShader(GL_VERTEX_SHADER),
+                    control = glCreateShader(GL_TESS_CONTROL_SHADER),
+                    evaluation = glCreateShader(GL_TESS_EVALUATION_SHADER),
+                    fragment = glCreateShader(GL_FRAGMENT_SHADER);
+
+          compile(vertex, loadFile(vertexShaderFilename));
+          compile(control, loadFile(tessellationControlShaderFilename));
+          compile(evaluation,
+                  loadFile(tessellationEvaluationShaderFilename));
+          compile(fragment, loadFile(fragmentShaderFilename));
+
+          int const shader = link(vertex, control, evaluation, fragment);
+
+          glDeleteShader(fragment);
+          glDeleteShader(evaluation);
+          glDeleteShader(control);
+          glDeleteShader(vertex);
+
+          return shader;
+      }()) {
+}
+
+Shader::Shader(string const &computeShaderFilename)
+    : shader([&]() -> int {
+          int const compute = glCreateShader(GL_COMPUTE_SHADER);
+
+          compile(compute, loadFile(computeShaderFilename));
+
+          int const shader = link(compute);
+
+          glDeleteShader(compute);
+
+          return shader;
+      }()) {
+}
+
 Shader::~Shader() {
-    glDeleteProgram(shader);
+    glstate::deleteProgram(shader);
 }
 
 void Shader::use() const {
-    glUseProgram(shader);
+    glstate::useProgram(shader);
+}
+
+unsigned int Shader::getProgram() const {
+    return shader;
 }
 
-void Shader::uniformMatrix4fv(string const &name,
+void Shader::uniformMatrix4fv(char const *name,
                               float const *value) {
     glUniformMatrix4fv(
-        glGetUniformLocation(shader, name.c_str()), 1, false, value);
+        glGetUniformLocation(shader, name), 1, false, value);
 }
 
-void Shader::uniform3f(string const &name,
+void Shader::uniform3f(char const *name,
                        float const a,
                        float const b,
                        float const c) {
     glUniform3f(
-        glGetUniformLocation(shader, name.c_str()),
+        glGetUniformLocation(shader, name),
         a, b, c);
 }
 
-void Shader::uniform1i(string const &name, int const a) {
+void Shader::uniform4fv(char const *name,
+                        int const count,
+                        float const *value) {
+    glUniform4fv(
+        glGetUniformLocation(shader, name), count, value);
+}
+
+void Shader::uniform1i(char const *name, int const a) {
     glUniform1i(
-        glGetUniformLocation(shader, name.c_str()), a);
+        glGetUniformLocation(shader, name), a);
+}
+
+void Shader::uniform1f(char const *name, float const a) {
+    glUniform1f(
+        glGetUniformLocation(shader, name), a);
+}
+
+void Shader::uniform1ui(char const *name, unsigned int const a) {
+    glUniform1ui(
+        glGetUniformLocation(shader, name), a);
 }
\ No newline at end of file
@@ -9,17 +9,34 @@ public: // ============================================ Public interface ==
            std::string const &geometryShaderFilename,
            std::string const &fragmentShaderFilename);
 
+    // Tessellated program, without a geometry stage
+    Shader(std::string const &vertexShaderFilename,
+           std::string const &tessellationControlShaderFilename,
+           std::string const &tessellationEvaluationShaderFilename,
+           std::string const &fragmentShaderFilename);
+
+    // Compute program
+    explicit Shader(std::string const &computeShaderFilename);
+
     ~Shader();
 
     void use() const;
+    unsigned int getProgram() const;
 
-    void uniformMatrix4fv(std::string const &name,
+    void uniformMatrix4fv(char const *name,
                           float const *value);
 
-    void uniform3f(std::string const &name,
+    void uniform3f(char const *name,
             float const a, float const b, float const c);
 
-    void uniform1i(std::string const &name, int const a);
+    void uniform4fv(char const *name, int const count,
+                    float const *value);
+
+    void uniform1i(char const *name, int const a);
+
+    void uniform1f(char const *name, float const a);
+
+    void uniform1ui(char const *name, unsigned int const a);
 
 private: // ===================================== Private implementation == 
     // ------------------------------------------------------------ Data --
@@ -0,0 +1,89 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "sphere-mesh.hpp"
+
+#include <cmath>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::vec2;
+using glm::vec3;
+
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    float const PI = 3.1415926535897932384626433832795f;
+
+    vec3 sphericalToCartesian(float const theta, float const phi) {
+        return vec3(std::cos(theta) * std::cos(phi),
+                    std::cos(theta) * std::sin(phi),
+                    std::sin(theta));
+    }
+
+    // One extra column closes the texture around the sphere; it reuses
+    // the first column's positions so the seam is watertight
+    void generateGrid(int const rings, int const segments,
+                      vector<Vertex> &vertices) {
+        float const v = static_cast<float>(rings);
+        float const h = static_cast<float>(segments);
+
+        vertices.clear();
+        vertices.reserve((rings + 1) * (segments + 1));
+        for (int i = 0; i <= rings; ++i) {
+            float const theta = (PI / 2.0f) - (PI * (i / v));
+
+            for (int j = 0; j <= segments; ++j) {
+                float const phi = (2.0f * PI) * ((j % segments) / h);
+                vertices.push_back({sphericalToCartesian(theta, phi),
+                                    vec2(i / v, j / h)});
+            }
+        }
+    }
+}
+
+// ///////////////////////////////////////////////////////// Sphere mesh //
+void generateSphereMesh(int const subdivisionLevel,
+                        vector<Vertex> &vertices,
+                        vector<unsigned int> &indices) {
+    int const rings = subdivisionLevel + 1;
+    int const segments = subdivisionLevel + 2;
+    generateGrid(rings, segments, vertices);
+
+    // The geometry shader's strips, split into triangles with the same
+    // winding
+    indices.clear();
+    indices.reserve(6 * rings * segments);
+    for (int i = 0; i < rings; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            unsigned int const a = i * (segments + 1) + j,
+                               b = a + segments + 1,
+                               c = a + 1,
+                               d = b + 1;
+            if (i > 0) {
+                indices.insert(indices.end(), {a, b, c});
+            }
+            if (i < rings - 1) {
+                indices.insert(indices.end(), {c, b, d});
+            }
+        }
+    }
+}
+
+void generateSpherePatches(int const subdivisionLevel,
+                           vector<Vertex> &vertices,
+                           vector<unsigned int> &indices) {
+    int const rings = subdivisionLevel + 1;
+    int const segments = subdivisionLevel + 2;
+    generateGrid(rings, segments, vertices);
+
+    indices.clear();
+    indices.reserve(4 * rings * segments);
+    for (int i = 0; i < rings; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            unsigned int const a = i * (segments + 1) + j,
+                               b = a + segments + 1;
+            indices.insert(indices.end(), {a, a + 1, b, b + 1});
+        }
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,29 @@
+#ifndef SPHERE_MESH_H
+#define SPHERE_MESH_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "geometry-buffer.hpp"
+
+#include <vector>
+
+// ///////////////////////////////////////////////////////// Sphere mesh //
+// Unit UV sphere around the origin with subdivisionLevel + 1 rings of
+// subdivisionLevel + 2 segments. Vertices and texture coordinates match
+// what res/shaders/sphere/geometry.glsl emits for the same level; the
+// triangles that collapse at the poles are left out. Indices start at 0.
+void generateSphereMesh(int subdivisionLevel,
+                        std::vector<Vertex> &vertices,
+                        std::vector<unsigned int> &indices);
+
+// The same grid as generateSphereMesh, as quad patches of four indices:
+// (0, 0), (1, 0), (0, 1) and (1, 1), with u running along the segments
+// and v along the rings. Patches at the poles keep their collapsed edge.
+// SPHERE_PATCH_SUBDIVISION_LEVEL is coarse enough for distant spheres,
+// and fine enough that a patch edge stays close to its arc.
+int const SPHERE_PATCH_SUBDIVISION_LEVEL = 6;
+
+void generateSpherePatches(int subdivisionLevel,
+                           std::vector<Vertex> &vertices,
+                           std::vector<unsigned int> &indices);
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // SPHERE_MESH_H
@@ -0,0 +1,45 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "stream-buffer.hpp"
+#include "gl-state.hpp"
+
+#include <algorithm>
+
+// ///////////////////////////////////////////////// Class: StreamBuffer //
+StreamBuffer::StreamBuffer(GLenum const target)
+        : target(target),
+          buffer(0),
+          capacity(0) {
+    glGenBuffers(1, &buffer);
+}
+
+StreamBuffer::~StreamBuffer() {
+    glstate::deleteBuffer(buffer);
+}
+
+void *StreamBuffer::map(std::size_t const size) {
+    bind();
+
+    if (size > capacity) {
+        // Grow geometrically so a slowly growing scene reallocates rarely
+        capacity = std::max(size, 2 * capacity);
+        glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    }
+
+    return glMapBufferRange(target, 0, size,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+}
+
+void StreamBuffer::unmap() {
+    bind();
+    glUnmapBuffer(target);
+}
+
+void StreamBuffer::bind() const {
+    glstate::bindBuffer(target, buffer);
+}
+
+GLuint StreamBuffer::getName() const {
+    return buffer;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,36 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "opengl-headers.hpp"
+
+#include <cstddef>
+
+// ///////////////////////////////////////////////// Class: StreamBuffer //
+// Buffer whose whole contents are rewritten from the CPU every frame.
+// map() invalidates the previous contents, so the driver can hand out
+// fresh memory instead of waiting for draws still reading the old one.
+// The storage grows geometrically and never shrinks.
+class StreamBuffer {
+public:
+    explicit StreamBuffer(GLenum target);
+    ~StreamBuffer();
+
+    StreamBuffer(StreamBuffer const &) = delete;
+    StreamBuffer &operator=(StreamBuffer const &) = delete;
+
+    // Write-only memory for size bytes, valid until unmap(). Leaves the
+    // buffer bound to its target.
+    void *map(std::size_t size);
+    void unmap();
+
+    void bind() const;
+    GLuint getName() const;
+
+private:
+    GLenum const target;
+    GLuint buffer;
+    std::size_t capacity;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // STREAM_BUFFER_H
@@ -0,0 +1,327 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "task-scheduler.hpp"
+
+#include <utility>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::size_t;
+using std::unique_lock;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // Lets a thread find its own queue; threads outside the scheduler use
+    // the owning thread's queue
+    thread_local TaskScheduler const *currentScheduler = nullptr;
+    thread_local unsigned currentQueue = 0;
+
+    size_t const INITIAL_QUEUE_CAPACITY = 256;
+}
+
+// ///////////////////////////////////////////////// Class: TaskCounter //
+TaskCounter::TaskCounter()
+        : pending(0) {
+}
+
+bool TaskCounter::isDone() const {
+    return pending.load(std::memory_order_acquire) == 0;
+}
+
+// ///////////////////////////////////// Struct: TaskScheduler::WorkerQueue //
+TaskScheduler::WorkerQueue::WorkerQueue()
+        : tasks(INITIAL_QUEUE_CAPACITY),
+          head(0),
+          count(0) {
+}
+
+void TaskScheduler::WorkerQueue::pushBack(Task const &task) {
+    if (count == tasks.size()) {
+        vector<Task> grown(tasks.size() * 2);
+        for (size_t i = 0; i < count; ++i) {
+            grown[i] = tasks[(head + i) % tasks.size()];
+        }
+        tasks.swap(grown);
+        head = 0;
+    }
+
+    tasks[(head + count) % tasks.size()] = task;
+    ++count;
+}
+
+bool TaskScheduler::WorkerQueue::popBack(Task &task) {
+    if (count == 0) {
+        return false;
+    }
+
+    --count;
+    task = tasks[(head + count) % tasks.size()];
+    return true;
+}
+
+bool TaskScheduler::WorkerQueue::popFront(Task &task) {
+    if (count == 0) {
+        return false;
+    }
+
+    task = tasks[head];
+    head = (head + 1) % tasks.size();
+    --count;
+    return true;
+}
+
+// /////////////////////////////////////////////// Class: TaskScheduler //
+TaskScheduler::TaskScheduler(unsigned const workerCount)
+        : queuedTasks(0),
+          stopping(false),
+          queuedBackgroundTasks(0),
+          runningBackgroundTasks(0),
+          // One worker is left for the tasks, as long as there are two;
+          // a single worker has to be shared
+          maxBackgroundTasks(std::max(workerCount, 2u) - 1) {
+    // Queue 0 belongs to the thread that owns the scheduler
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues.emplace_back(new WorkerQueue());
+    }
+
+    currentScheduler = this;
+    currentQueue = 0;
+
+    for (unsigned i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    // Finish whatever is still queued before shutting the workers down;
+    // background work may take long and is dropped, apart from what is
+    // already running
+    while (runOneTask(0)) {
+    }
+
+    stopping = true;
+    {
+        lock_guard<mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (currentScheduler == this) {
+        currentScheduler = nullptr;
+    }
+}
+
+unsigned TaskScheduler::defaultWorkerCount() {
+    unsigned const hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+unsigned TaskScheduler::getThreadCount() const {
+    return static_cast<unsigned>(queues.size());
+}
+
+void TaskScheduler::submit(Task const &task) {
+    if (task.counter != nullptr) {
+        task.counter->pending.fetch_add(1);
+    }
+
+    push(task);
+    wakeWorkers();
+}
+
+void TaskScheduler::submit(Task const &task, TaskCounter &dependency) {
+    if (task.counter != nullptr) {
+        task.counter->pending.fetch_add(1);
+    }
+
+    {
+        // finish() takes the same lock after the counter reaches zero, so
+        // a continuation is either queued here or picked up there
+        lock_guard<mutex> lock(dependency.continuationsMutex);
+        if (!dependency.isDone()) {
+            dependency.continuations.push_back(task);
+            return;
+        }
+    }
+
+    push(task);
+    wakeWorkers();
+}
+
+void TaskScheduler::submit(function<void()> function,
+                           TaskCounter *const counter) {
+    Task task;
+    task.function = [](void *data, size_t, size_t) {
+        std::unique_ptr<std::function<void()>> const callable(
+                static_cast<std::function<void()> *>(data));
+        (*callable)();
+    };
+    task.data = new std::function<void()>(std::move(function));
+    task.begin = 0;
+    task.end = 0;
+    task.counter = counter;
+
+    submit(task);
+}
+
+void TaskScheduler::wait(TaskCounter &counter) {
+    unsigned const index = getCurrentQueue();
+
+    while (!counter.isDone()) {
+        if (!runOneTask(index)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Let the thread that finished the last task leave finish()
+    lock_guard<mutex> lock(counter.continuationsMutex);
+}
+
+void TaskScheduler::submitBackground(function<void()> function) {
+    if (workers.empty()) {
+        function();
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(backgroundMutex);
+        backgroundTasks.push_back(std::move(function));
+    }
+    queuedBackgroundTasks.fetch_add(1);
+    wakeWorkers();
+}
+
+void TaskScheduler::workerLoop(unsigned const index) {
+    currentScheduler = this;
+    currentQueue = index;
+
+    // Tasks first: someone may be waiting for them
+    while (!stopping) {
+        if (runOneTask(index) || runBackgroundTask()) {
+            continue;
+        }
+
+        unique_lock<mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this]() {
+            return hasWork() || stopping.load();
+        });
+    }
+}
+
+unsigned TaskScheduler::getCurrentQueue() const {
+    return currentScheduler == this ? currentQueue : 0;
+}
+
+void TaskScheduler::push(Task const &task) {
+    WorkerQueue &queue = *queues[getCurrentQueue()];
+    {
+        lock_guard<mutex> lock(queue.mutex);
+        queue.pushBack(task);
+    }
+    queuedTasks.fetch_add(1);
+}
+
+void TaskScheduler::wakeWorkers() {
+    if (workers.empty()) {
+        return;
+    }
+
+    // Taking the lock orders this with a worker checking for work, so the
+    // notification cannot be lost
+    {
+        lock_guard<mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_all();
+}
+
+bool TaskScheduler::runOneTask(unsigned const index) {
+    Task task;
+    bool found = false;
+
+    // Own queue first, newest task - it is most likely still in cache
+    {
+        WorkerQueue &queue = *queues[index];
+        lock_guard<mutex> lock(queue.mutex);
+        found = queue.popBack(task);
+    }
+
+    // Then steal the oldest task from someone else
+    for (size_t i = 1; !found && i < queues.size(); ++i) {
+        WorkerQueue &queue = *queues[(index + i) % queues.size()];
+        lock_guard<mutex> lock(queue.mutex);
+        found = queue.popFront(task);
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    queuedTasks.fetch_sub(1);
+    execute(task);
+    return true;
+}
+
+bool TaskScheduler::runBackgroundTask() {
+    function<void()> function;
+    {
+        lock_guard<mutex> lock(backgroundMutex);
+        if (backgroundTasks.empty()
+            || runningBackgroundTasks.load() >= maxBackgroundTasks) {
+            return false;
+        }
+
+        function = std::move(backgroundTasks.front());
+        backgroundTasks.pop_front();
+        queuedBackgroundTasks.fetch_sub(1);
+        runningBackgroundTasks.fetch_add(1);
+    }
+
+    function();
+
+    // A worker may be asleep because the limit was reached
+    runningBackgroundTasks.fetch_sub(1);
+    if (queuedBackgroundTasks.load() > 0) {
+        wakeWorkers();
+    }
+    return true;
+}
+
+bool TaskScheduler::hasWork() const {
+    return queuedTasks.load() > 0
+           || (queuedBackgroundTasks.load() > 0
+               && runningBackgroundTasks.load() < maxBackgroundTasks);
+}
+
+void TaskScheduler::execute(Task const &task) {
+    task.function(task.data, task.begin, task.end);
+
+    if (task.counter != nullptr) {
+        finish(*task.counter);
+    }
+}
+
+void TaskScheduler::finish(TaskCounter &counter) {
+    vector<Task> ready;
+    {
+        // The decrement happens under the lock - wait() takes it too before
+        // returning, so the counter outlives this block
+        lock_guard<mutex> lock(counter.continuationsMutex);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter.continuations);
+        }
+    }
+
+    for (Task const &task : ready) {
+        push(task);
+    }
+    if (!ready.empty()) {
+        wakeWorkers();
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,178 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+// //////////////////////////////////////////////////////////// Includes //
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class TaskCounter;
+
+// //////////////////////////////////////////////////////// Struct: Task //
+// Plain function pointer plus a range, so queuing a task never allocates
+struct Task {
+    void (*function)(void *data, std::size_t begin, std::size_t end);
+    void *data;
+    std::size_t begin;
+    std::size_t end;
+    TaskCounter *counter;
+};
+
+// ///////////////////////////////////////////////// Class: TaskCounter //
+// Number of unfinished tasks in a group. Tasks can be made to depend on a
+// counter: they are held back until it drops to zero.
+class TaskCounter {
+public:
+    TaskCounter();
+
+    TaskCounter(TaskCounter const &) = delete;
+    TaskCounter &operator=(TaskCounter const &) = delete;
+
+    bool isDone() const;
+
+private:
+    friend class TaskScheduler;
+
+    std::atomic<int> pending;
+
+    std::mutex continuationsMutex;
+    std::vector<Task> continuations;
+};
+
+// /////////////////////////////////////////////// Class: TaskScheduler //
+// Work-stealing job system. Every worker - and the thread that owns the
+// scheduler - has its own queue: the owner pushes and pops at the back,
+// idle threads steal from the front of other queues. Threads waiting on a
+// counter keep executing tasks instead of blocking.
+//
+// Long-running work, such as loading files, goes to a separate background
+// queue instead: only idle workers take it, and threads waiting on a
+// counter never do. A frame waiting for its own tasks is thus never held
+// up behind an import, and the loads share the worker threads rather than
+// adding threads of their own. With two or more workers, at most all but
+// one of them run background work at a time, so a worker is always left
+// for the tasks. A single worker still takes background work whenever no
+// tasks are queued; while it runs, the owning thread executes the frame's
+// tasks alone, which costs frame time for as long as the load lasts.
+class TaskScheduler {
+public:
+    explicit TaskScheduler(unsigned workerCount = defaultWorkerCount());
+    ~TaskScheduler();
+
+    TaskScheduler(TaskScheduler const &) = delete;
+    TaskScheduler &operator=(TaskScheduler const &) = delete;
+
+    static unsigned defaultWorkerCount();
+
+    // Worker threads plus the owning thread
+    unsigned getThreadCount() const;
+
+    void submit(Task const &task);
+    void submit(Task const &task, TaskCounter &dependency);
+
+    void submit(std::function<void()> function,
+                TaskCounter *counter = nullptr);
+
+    void wait(TaskCounter &counter);
+
+    // The function must not throw. Without workers it runs at once on
+    // the calling thread; functions still queued when the scheduler is
+    // destroyed are dropped.
+    void submitBackground(std::function<void()> function);
+
+    // Calls function(chunkBegin, chunkEnd) over [begin, end) in chunks of
+    // at most grainSize elements and returns once all of them are done
+    template <typename Function>
+    void parallelFor(std::size_t const begin, std::size_t const end,
+                     std::size_t const grainSize, Function &&function) {
+        if (begin >= end) {
+            return;
+        }
+
+        std::size_t const grain = std::max<std::size_t>(grainSize, 1);
+        if (end - begin <= grain || queues.size() == 1) {
+            function(begin, end);
+            return;
+        }
+
+        using FunctionType = typename std::remove_reference<Function>::type;
+
+        TaskCounter counter;
+        Task task;
+        task.function = [](void *data, std::size_t const first,
+                           std::size_t const last) {
+            (*static_cast<FunctionType *>(data))(first, last);
+        };
+        task.data = const_cast<void *>(
+                static_cast<void const *>(&function));
+        task.counter = &counter;
+
+        std::size_t const chunkCount = (end - begin + grain - 1) / grain;
+        counter.pending.fetch_add(static_cast<int>(chunkCount));
+
+        // Queue all chunks but the first, then run the first one here
+        for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            task.begin = begin + chunk * grain;
+            task.end = std::min(end, task.begin + grain);
+            push(task);
+        }
+        wakeWorkers();
+
+        task.begin = begin;
+        task.end = std::min(end, begin + grain);
+        execute(task);
+
+        wait(counter);
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        // Ring buffer that only ever grows, so steady-state use does not
+        // allocate
+        std::vector<Task> tasks;
+        std::size_t head;
+        std::size_t count;
+
+        WorkerQueue();
+
+        void pushBack(Task const &task);
+        bool popBack(Task &task);
+        bool popFront(Task &task);
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<int> queuedTasks;
+    std::atomic<bool> stopping;
+
+    std::mutex backgroundMutex;
+    std::deque<std::function<void()>> backgroundTasks;
+    std::atomic<int> queuedBackgroundTasks;
+    std::atomic<unsigned> runningBackgroundTasks;
+    unsigned maxBackgroundTasks;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    void workerLoop(unsigned index);
+
+    unsigned getCurrentQueue() const;
+    void push(Task const &task);
+    void wakeWorkers();
+    bool runOneTask(unsigned index);
+    bool runBackgroundTask();
+    bool hasWork() const;
+    void execute(Task const &task);
+    void finish(TaskCounter &counter);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,139 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "texture-cache.hpp"
+#include "gl-state.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using std::string;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    // What uploadTexture() leaves in video memory: RGB texels for every
+    // mipmap level down to 1x1
+    std::size_t getResidentSize(Image const &image) {
+        std::size_t size = 0;
+        int width = image.width,
+            height = image.height;
+        for (;;) {
+            size += static_cast<std::size_t>(width) * height * 3;
+            if (width == 1 && height == 1) {
+                return size;
+            }
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+    }
+}
+
+// ///////////////////////////////////////////////// Class: TextureCache //
+TextureCache::TextureCache(Loader loader)
+        : loader(std::move(loader)),
+          statistics{0, 0, 0, 0} {
+}
+
+TextureCache::~TextureCache() {
+    for (auto const &entry : entries) {
+        glstate::deleteTexture(entry.second.texture);
+    }
+}
+
+string TextureCache::canonicalize(string const &path) {
+    bool const absolute = !path.empty()
+                          && (path[0] == '/' || path[0] == '\\');
+
+    vector<string> segments;
+    std::size_t begin = 0;
+    while (begin <= path.size()) {
+        std::size_t end = path.find_first_of("/\\", begin);
+        if (end == string::npos) {
+            end = path.size();
+        }
+        string const segment = path.substr(begin, end - begin);
+        begin = end + 1;
+
+        if (segment.empty() || segment == ".") {
+            continue;
+        }
+        // A leading ".." of a relative path has nothing to cancel
+        if (segment == ".." && !segments.empty()
+            && segments.back() != "..") {
+            segments.pop_back();
+        } else if (segment != ".." || !absolute) {
+            segments.push_back(segment);
+        }
+    }
+
+    string canonical = absolute ? "/" : "";
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        canonical += (i > 0 ? "/" : "") + segments[i];
+    }
+    return canonical;
+}
+
+GLuint TextureCache::acquire(string const &path) {
+    string const canonical = canonicalize(path);
+
+    auto const found = entries.find(canonical);
+    if (found != entries.end()) {
+        ++statistics.hits;
+        ++found->second.references;
+        return found->second.texture;
+    }
+    ++statistics.misses;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    uploadPlaceholder(texture);
+
+    entries[canonical] = Entry{texture, 1, 0, false};
+    paths[texture] = canonical;
+
+    if (loader) {
+        loader(canonical);
+    } else {
+        upload(canonical, loadImage(canonical));
+    }
+    return texture;
+}
+
+void TextureCache::release(GLuint const texture) {
+    auto const path = paths.find(texture);
+    if (path == paths.end()) {
+        return;
+    }
+
+    auto const entry = entries.find(path->second);
+    if (--entry->second.references > 0) {
+        return;
+    }
+
+    statistics.residentBytes -= entry->second.size;
+    glstate::deleteTexture(texture);
+    entries.erase(entry);
+    paths.erase(path);
+}
+
+bool TextureCache::upload(string const &path, Image const &image) {
+    auto const entry = entries.find(path);
+    if (entry == entries.end() || entry->second.uploaded) {
+        return false;
+    }
+
+    uploadTexture(entry->second.texture, image);
+    entry->second.size = getResidentSize(image);
+    entry->second.uploaded = true;
+    statistics.residentBytes += entry->second.size;
+    return true;
+}
+
+TextureCache::Statistics TextureCache::getStatistics() const {
+    Statistics current = statistics;
+    current.textureCount = entries.size();
+    return current;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
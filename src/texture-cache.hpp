@@ -0,0 +1,73 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "image.hpp"
+
+#include "opengl-headers.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+
+// ///////////////////////////////////////////////// Class: TextureCache //
+// One OpenGL texture per image file, shared by everything that asks for
+// it. Files are keyed by their canonical path, so "res\textures\a.jpg"
+// from a Windows-made material and "res/./textures/a.jpg" are the same
+// texture. Every acquire() takes a reference and every release() drops
+// one; the texture is deleted with its last reference, and whatever is
+// left is deleted with the cache.
+//
+// On a miss the texture is created at once, holding a placeholder, and
+// the loader is asked to fill it: either on the spot (no loader given)
+// or later, through upload(), once the image has been decoded elsewhere.
+// Context thread only.
+class TextureCache {
+public:
+    struct Statistics {
+        std::size_t hits;
+        std::size_t misses;
+        std::size_t textureCount;
+        // Uploaded images including their mipmaps; placeholders are
+        // not counted
+        std::size_t residentBytes;
+    };
+
+    // Gets the canonical path of a texture that has to be filled
+    using Loader = std::function<void(std::string const &path)>;
+
+    explicit TextureCache(Loader loader = Loader());
+    ~TextureCache();
+
+    TextureCache(TextureCache const &) = delete;
+    TextureCache &operator=(TextureCache const &) = delete;
+
+    // Forward slashes, no "." segments, ".." resolved where possible
+    static std::string canonicalize(std::string const &path);
+
+    GLuint acquire(std::string const &path);
+    void release(GLuint texture);
+
+    // Fills the texture of a canonical path; false, and nothing done,
+    // when nobody holds the texture any more or it was already filled
+    bool upload(std::string const &path, Image const &image);
+
+    Statistics getStatistics() const;
+
+private:
+    struct Entry {
+        GLuint texture;
+        std::size_t references;
+        std::size_t size;
+        bool uploaded;
+    };
+
+    Loader loader;
+
+    std::map<std::string, Entry> entries;
+    std::map<GLuint, std::string> paths;
+    Statistics statistics;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // TEXTURE_CACHE_H
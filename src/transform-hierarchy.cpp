@@ -0,0 +1,301 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "transform-hierarchy.hpp"
+#include "matrix-kernels.hpp"
+#include "task-scheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+
+using std::exception;
+using std::vector;
+
+// /////////////////////////////// Struct: TransformHierarchy::MatrixBatch //
+struct TransformHierarchy::MatrixBatch {
+    static std::size_t const CAPACITY = 64;
+
+    mat4 const *lhs[CAPACITY];
+    mat4 const *rhs[CAPACITY];
+    mat4 *result[CAPACITY];
+
+    // Local transforms expanded to matrices for the kernel; they and the
+    // world matrices built from them are affine, so the kernel skips the
+    // terms of the constant bottom row
+    mat4 localMatrices[CAPACITY];
+    std::size_t count;
+
+    MatrixBatchKernel const multiply;
+
+    explicit MatrixBatch(MatrixBatchKernel const multiply)
+            : count(0),
+              multiply(multiply) {
+    }
+
+    void add(mat4 const *parent, Transform const &local, mat4 *product) {
+        localMatrices[count] = local.toMatrix();
+
+        lhs[count] = parent;
+        rhs[count] = &localMatrices[count];
+        result[count] = product;
+
+        if (++count == CAPACITY) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (count != 0) {
+            multiply(lhs, rhs, result, count);
+            count = 0;
+        }
+    }
+};
+
+// /////////////////////////////////////////// Class: TransformHierarchy //
+TransformHierarchy::Index const TransformHierarchy::NO_PARENT;
+TransformHierarchy::Index const TransformHierarchy::REMOVED;
+std::size_t const TransformHierarchy::PARALLEL_THRESHOLD;
+std::size_t const TransformHierarchy::PARALLEL_GRAIN_SIZE;
+
+TransformHierarchy::TransformHierarchy()
+        : firstDirty(0),
+          minDirtyDepth(UINT32_MAX),
+          levelsDirty(false) {
+}
+
+TransformHierarchy::Index TransformHierarchy::add(Index const parent,
+                                                  Transform const &local) {
+    Index const count = static_cast<Index>(parents.size());
+
+    if (parent != NO_PARENT &&
+        (parent >= count || parents[parent] == REMOVED)) {
+        throw exception("Parent must be added before its children!");
+    }
+
+    // Reuse the most recently freed slot as long as it still comes after
+    // the parent, otherwise append
+    Index index = count;
+    if (!freeSlots.empty() &&
+        (parent == NO_PARENT || freeSlots.back() > parent)) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+
+        parents[index] = parent;
+        locals[index] = local;
+        childCounts[index] = 0;
+    } else {
+        parents.push_back(parent);
+        locals.push_back(local);
+        worlds.push_back(mat4(1.0f));
+        dirty.push_back(0);
+        childCounts.push_back(0);
+        depths.push_back(0);
+    }
+
+    if (parent != NO_PARENT) {
+        ++childCounts[parent];
+        depths[index] = depths[parent] + 1;
+    } else {
+        depths[index] = 0;
+    }
+
+    levelsDirty = true;
+    markDirty(index);
+    return index;
+}
+
+void TransformHierarchy::remove(Index const index) {
+    if (childCounts[index] != 0) {
+        throw exception("Children must be removed before their parent!");
+    }
+
+    Index const parent = parents[index];
+    if (parent != NO_PARENT) {
+        --childCounts[parent];
+    }
+
+    parents[index] = REMOVED;
+    dirty[index] = 0;
+    freeSlots.push_back(index);
+}
+
+void TransformHierarchy::setLocal(Index const index,
+                                  Transform const &local) {
+    locals[index] = local;
+    markDirty(index);
+}
+
+Transform const &TransformHierarchy::getLocal(Index const index) const {
+    return locals[index];
+}
+
+mat4 const &TransformHierarchy::getWorld(Index const index) const {
+    return worlds[index];
+}
+
+TransformHierarchy::Index TransformHierarchy::getParent(
+        Index const index) const {
+    return parents[index];
+}
+
+std::uint32_t TransformHierarchy::getChildCount(Index const index) const {
+    return childCounts[index];
+}
+
+vector<mat4> const &TransformHierarchy::getWorldTransforms() const {
+    return worlds;
+}
+
+std::size_t TransformHierarchy::size() const {
+    return parents.size();
+}
+
+void TransformHierarchy::update(TaskScheduler *const scheduler) {
+    propagate(scheduler, scheduler != nullptr &&
+                         scheduler->getThreadCount() > 1 &&
+                         firstDirty < parents.size() &&
+                         parents.size() - firstDirty >= PARALLEL_THRESHOLD);
+}
+
+void TransformHierarchy::updateByLevel(TaskScheduler &scheduler) {
+    propagate(&scheduler, true);
+}
+
+vector<TransformHierarchy::Index> const &
+TransformHierarchy::getChanged() const {
+    return changed;
+}
+
+void TransformHierarchy::propagate(TaskScheduler *const scheduler,
+                                   bool const byLevel) {
+    Index const count = static_cast<Index>(parents.size());
+
+    // Forget what the previous update changed
+    changed.clear();
+
+    if (firstDirty >= count) {
+        return;
+    }
+
+    if (byLevel) {
+        updateParallel(*scheduler);
+        // The levels are not in index order; one pass over the dirty range
+        // is cheap next to the products
+        for (Index i = firstDirty; i < count; ++i) {
+            if (dirty[i] && parents[i] != REMOVED) {
+                changed.push_back(i);
+            }
+        }
+    } else {
+        updateSerial();
+    }
+
+    // After propagation the dirty flags are exactly the changed nodes
+    for (Index const index : changed) {
+        dirty[index] = 0;
+    }
+    firstDirty = count;
+    minDirtyDepth = UINT32_MAX;
+}
+
+void TransformHierarchy::updateNode(Index const index, MatrixBatch &batch) {
+    Index const parent = parents[index];
+
+    if (parent == REMOVED) {
+        return;
+    }
+    if (parent == NO_PARENT) {
+        if (dirty[index]) {
+            worlds[index] = locals[index].toMatrix();
+        }
+    } else {
+        dirty[index] |= dirty[parent];
+        if (dirty[index]) {
+            batch.add(&worlds[parent], locals[index], &worlds[index]);
+        }
+    }
+}
+
+void TransformHierarchy::updateSerial() {
+    MatrixBatch batch(getMatrixKernel().multiplyAffine);
+    Index batchBegin = firstDirty;
+
+    // Parents precede their children, so by the time a node is visited its
+    // parent's dirty flag is final; its world matrix may still be waiting
+    // in the batch, in which case the batch is computed first
+    Index const count = static_cast<Index>(parents.size());
+    for (Index i = firstDirty; i < count; ++i) {
+        Index const parent = parents[i];
+        if (batch.count != 0 && parent < REMOVED && parent >= batchBegin) {
+            batch.flush();
+        }
+        if (batch.count == 0) {
+            batchBegin = i;
+        }
+
+        updateNode(i, batch);
+        if (dirty[i] && parent != REMOVED) {
+            changed.push_back(i);
+        }
+    }
+    batch.flush();
+}
+
+void TransformHierarchy::updateParallel(TaskScheduler &scheduler) {
+    if (levelsDirty) {
+        rebuildLevels();
+    }
+
+    MatrixBatchKernel const multiply = getMatrixKernel().multiplyAffine;
+
+    // Nodes of one level only read the previous level, which parallelFor
+    // has already completed; levels above the shallowest change are clean
+    for (std::size_t level = minDirtyDepth;
+         level + 1 < levelOffsets.size(); ++level) {
+        scheduler.parallelFor(
+                levelOffsets[level], levelOffsets[level + 1],
+                PARALLEL_GRAIN_SIZE,
+                [this, multiply](std::size_t const begin,
+                                 std::size_t const end) {
+                    MatrixBatch batch(multiply);
+                    for (std::size_t i = begin; i < end; ++i) {
+                        updateNode(levelOrder[i], batch);
+                    }
+                    batch.flush();
+                });
+    }
+}
+
+void TransformHierarchy::rebuildLevels() {
+    // Counting sort by depth; within a level nodes stay in index order
+    std::uint32_t maxDepth = 0;
+    for (std::uint32_t const depth : depths) {
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    levelOffsets.assign(maxDepth + 2, 0);
+    for (std::uint32_t const depth : depths) {
+        ++levelOffsets[depth + 1];
+    }
+    for (std::size_t level = 1; level < levelOffsets.size(); ++level) {
+        levelOffsets[level] += levelOffsets[level - 1];
+    }
+
+    vector<std::size_t> next(levelOffsets.begin(), levelOffsets.end() - 1);
+    levelOrder.resize(depths.size());
+    for (Index i = 0; i < depths.size(); ++i) {
+        levelOrder[next[depths[i]]++] = i;
+    }
+
+    levelsDirty = false;
+}
+
+void TransformHierarchy::markDirty(Index const index) {
+    dirty[index] = 1;
+    firstDirty = std::min(firstDirty, index);
+    minDirtyDepth = std::min(minDirtyDepth, depths[index]);
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,90 @@
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "transform.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class TaskScheduler;
+
+// /////////////////////////////////////////// Class: TransformHierarchy //
+// Transform hierarchy stored as parallel arrays in topological order
+// (local TRS transforms in, world matrices out):
+// a node's parent always has a smaller index than the node itself, so
+// world matrices come out of a single linear pass. Removed nodes leave a
+// hole that is reused by a later add() when the order allows it. Large
+// updates are instead run depth level by depth level, each level split
+// across the task scheduler. Either way, the products go through the
+// affine variant of the widest batched matrix kernel the CPU supports.
+class TransformHierarchy {
+public:
+    using Index = std::uint32_t;
+    static Index const NO_PARENT = UINT32_MAX;
+    static Index const REMOVED = UINT32_MAX - 1;
+
+    TransformHierarchy();
+
+    Index add(Index parent, Transform const &local = Transform());
+    void remove(Index index);
+
+    void setLocal(Index index, Transform const &local);
+    Transform const &getLocal(Index index) const;
+    glm::mat4 const &getWorld(Index index) const;
+    Index getParent(Index index) const;
+    std::uint32_t getChildCount(Index index) const;
+
+    std::vector<glm::mat4> const &getWorldTransforms() const;
+    std::size_t size() const;
+
+    void update(TaskScheduler *scheduler = nullptr);
+
+    // Same as update(), but always level by level, whatever the size of
+    // the change and the number of threads - for comparing the parallel
+    // path against itself on fewer threads
+    void updateByLevel(TaskScheduler &scheduler);
+
+    // Nodes whose world matrix the last update() recomputed, in index
+    // order, so work that follows a change costs as much as the change
+    std::vector<Index> const &getChanged() const;
+
+private:
+    // Dirty ranges smaller than this are not worth spreading over threads
+    static std::size_t const PARALLEL_THRESHOLD = 16384;
+    static std::size_t const PARALLEL_GRAIN_SIZE = 2048;
+
+    // Products gathered for the batched matrix kernel
+    struct MatrixBatch;
+
+    std::vector<Index> parents;
+    std::vector<Transform> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<std::uint8_t> dirty;
+    std::vector<Index> changed;
+    std::vector<std::uint32_t> childCounts;
+    std::vector<std::uint32_t> depths;
+
+    std::vector<Index> freeSlots;
+
+    // Lowest dirty index and depth - everything before them is up to date
+    Index firstDirty;
+    std::uint32_t minDirtyDepth;
+
+    // Node indices grouped by depth, rebuilt after nodes are added
+    std::vector<Index> levelOrder;
+    std::vector<std::size_t> levelOffsets;
+    bool levelsDirty;
+
+    void propagate(TaskScheduler *scheduler, bool byLevel);
+    void updateNode(Index index, MatrixBatch &batch);
+    void updateSerial();
+    void updateParallel(TaskScheduler &scheduler);
+    void rebuildLevels();
+    void markDirty(Index index);
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // TRANSFORM_HIERARCHY_H
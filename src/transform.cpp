@@ -0,0 +1,67 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "transform.hpp"
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::quat;
+using glm::vec3;
+using glm::vec4;
+
+// //////////////////////////////////////////////////// Struct: Transform //
+Transform::Transform()
+        : translation(0.0f),
+          rotation(1.0f, 0.0f, 0.0f, 0.0f),
+          scale(1.0f) {
+}
+
+Transform::Transform(vec3 const &translation,
+                     quat const &rotation,
+                     vec3 const &scale)
+        : translation(translation),
+          rotation(rotation),
+          scale(scale) {
+}
+
+Transform Transform::fromTranslation(vec3 const &translation) {
+    return Transform(translation, quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f));
+}
+
+Transform Transform::fromRotation(float const angle, vec3 const &axis) {
+    return Transform(vec3(0.0f), glm::angleAxis(angle, glm::normalize(axis)),
+                     vec3(1.0f));
+}
+
+Transform Transform::fromScale(vec3 const &scale) {
+    return Transform(vec3(0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), scale);
+}
+
+Transform Transform::operator*(Transform const &child) const {
+    return Transform(translation + rotation * (scale * child.translation),
+                     rotation * child.rotation,
+                     scale * child.scale);
+}
+
+mat4 Transform::toMatrix() const {
+    // Rotation matrix straight from the quaternion, columns pre-scaled
+    float const x = rotation.x, y = rotation.y, z = rotation.z,
+                w = rotation.w;
+    float const xx = x * x, yy = y * y, zz = z * z,
+                xy = x * y, xz = x * z, yz = y * z,
+                wx = w * x, wy = w * y, wz = w * z;
+
+    return mat4(vec4((1.0f - 2.0f * (yy + zz)) * scale.x,
+                     2.0f * (xy + wz) * scale.x,
+                     2.0f * (xz - wy) * scale.x,
+                     0.0f),
+                vec4(2.0f * (xy - wz) * scale.y,
+                     (1.0f - 2.0f * (xx + zz)) * scale.y,
+                     2.0f * (yz + wx) * scale.y,
+                     0.0f),
+                vec4(2.0f * (xz + wy) * scale.z,
+                     2.0f * (yz - wx) * scale.z,
+                     (1.0f - 2.0f * (xx + yy)) * scale.z,
+                     0.0f),
+                vec4(translation, 1.0f));
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,34 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+// //////////////////////////////////////////////////////////// Includes //
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+// //////////////////////////////////////////////////// Struct: Transform //
+// Local transform kept as translation, rotation and scale - 10 floats in
+// place of a 16-float matrix. Building one takes a single sine/cosine
+// pair per rotation and no 4x4 products; toMatrix() expands it straight
+// into an affine matrix.
+struct Transform {
+    glm::vec3 translation;
+    glm::quat rotation;
+    glm::vec3 scale;
+
+    Transform();
+    Transform(glm::vec3 const &translation,
+              glm::quat const &rotation,
+              glm::vec3 const &scale);
+
+    static Transform fromTranslation(glm::vec3 const &translation);
+    static Transform fromRotation(float angle, glm::vec3 const &axis);
+    static Transform fromScale(glm::vec3 const &scale);
+
+    // Same as multiplying the matrices, provided the left-hand scale is
+    // uniform - otherwise the product would need a shear
+    Transform operator*(Transform const &child) const;
+
+    glm::mat4 toMatrix() const;
+};
+
+// ///////////////////////////////////////////////////////////////////// //
+#endif // TRANSFORM_H
@@ -0,0 +1,67 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "detail-level.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    int const LEVEL_COUNT = 4;
+
+    struct TestCase {
+        char const *name;
+        // Continuous level the screen size stands for
+        float ideal;
+        int previousLevel;
+        int expectedLevel;
+    };
+
+    float sizeOf(float const ideal) {
+        return DETAIL_FULL_SIZE * std::exp2(-ideal);
+    }
+}
+
+// //////////////////////////////////////////////////////////////// Main //
+int main() {
+    int failures = 0;
+
+    TestCase const cases[] = {
+            {"Larger than full detail", -2.0f, 0, 0},
+            {"Full detail size", 0.0f, 0, 0},
+            {"Shrinking within the hysteresis", 1.1f, 0, 0},
+            {"Shrinking past the hysteresis", 1.3f, 0, 1},
+            {"Shrinking past several levels", 2.5f, 0, 2},
+            {"Growing within the hysteresis", 0.9f, 1, 1},
+            {"Growing past the hysteresis", 0.7f, 1, 0},
+            {"Growing past several levels", -1.0f, 3, 0},
+            {"Smaller than the coarsest level", 10.0f, 0, LEVEL_COUNT - 1},
+            {"Coarsest level kept", 10.0f, LEVEL_COUNT - 1, LEVEL_COUNT - 1}};
+
+    for (TestCase const &test : cases) {
+        int const level = selectDetailLevel(sizeOf(test.ideal),
+                                            test.previousLevel, LEVEL_COUNT);
+        bool const passed = level == test.expectedLevel;
+        std::printf("%s: level %d after %d, expected %d%s\n",
+                    test.name, level, test.previousLevel,
+                    test.expectedLevel, passed ? "" : " - FAILED");
+        failures += !passed;
+    }
+
+    // Hovering around a level boundary never switches back and forth
+    int level = 0, switches = 0;
+    for (int frame = 0; frame < 100; ++frame) {
+        float const ideal = 1.0f + (frame % 2 == 0 ? 0.15f : -0.15f);
+        int const next = selectDetailLevel(sizeOf(ideal), level,
+                                           LEVEL_COUNT);
+        switches += next != level;
+        level = next;
+    }
+    bool const passed = switches == 0;
+    std::printf("Hovering around a boundary: %d switches%s\n",
+                switches, passed ? "" : " - FAILED");
+    failures += !passed;
+
+    return failures == 0 ? 0 : 1;
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,293 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "bounds.hpp"
+#include "gpu-culling.hpp"
+#include "opengl-headers.hpp"
+#include "stream-buffer.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::mat4;
+using glm::vec3;
+using glm::vec4;
+
+using std::size_t;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+// Runs the culling compute shader against Frustum on the CPU. It needs no
+// GPU: any EGL implementation with OpenGL 4.3, e.g. Mesa's llvmpipe, will
+// do, and without one the test reports itself skipped.
+namespace {
+    // ctest's SKIP_RETURN_CODE for this test
+    int const SKIPPED = 77;
+
+    size_t const INSTANCE_COUNT = 20000;
+    size_t const COMMAND_COUNT = 7;
+
+    // Spheres this close to a frustum plane may end up on either side
+    // of it on the GPU
+    float const PLANE_TOLERANCE = 1e-3f;
+
+    // Layout glMultiDrawElementsIndirect reads
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    enum Expected {
+        CULLED,
+        VISIBLE,
+        EITHER
+    };
+
+    bool createContext() {
+        // Surfaceless where Mesa offers it, so no display server is needed
+        EGLDisplay display = EGL_NO_DISPLAY;
+        auto const getPlatformDisplay =
+                reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay != nullptr) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                         EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint major, minor;
+        if (display == EGL_NO_DISPLAY
+            || !eglInitialize(display, &major, &minor)
+            || !eglBindAPI(EGL_OPENGL_API)) {
+            return false;
+        }
+
+        EGLint const configAttributes[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_NONE};
+        EGLConfig config;
+        EGLint configCount = 0;
+        eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+        EGLint const contextAttributes[] = {
+                EGL_CONTEXT_MAJOR_VERSION, 4,
+                EGL_CONTEXT_MINOR_VERSION, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE};
+        EGLContext const context = eglCreateContext(
+                display, configCount > 0 ? config : EGL_NO_CONFIG_KHR,
+                EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT
+            || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                               context)) {
+            return false;
+        }
+
+        return gladLoadGLLoader(
+                reinterpret_cast<GLADloadproc>(eglGetProcAddress)) != 0;
+    }
+
+    // Random placement, rotation and non-uniform scale around the camera,
+    // so instances fall inside, outside and across the frustum
+    mat4 randomWorld(std::mt19937 &random) {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> scale(0.25f, 3.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2832f);
+        std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+
+        mat4 world = glm::translate(mat4(1.0f), vec3(
+                position(random), position(random), position(random)));
+        world = glm::rotate(world, angle(random), glm::normalize(vec3(
+                axis(random), axis(random), axis(random)) + vec3(0.01f)));
+        return glm::scale(world, vec3(
+                scale(random), scale(random), scale(random)));
+    }
+
+    Expected cullOnCpu(Frustum const &frustum, BoundingSphere const &sphere,
+                       mat4 const &world) {
+        BoundingSphere const worldSphere = sphere.transformed(world);
+        if (worldSphere.isEmpty()) {
+            return CULLED;
+        }
+
+        // Distance by which the sphere clears the nearest plane
+        float margin = INFINITY;
+        for (int i = 0; i < 6; ++i) {
+            vec4 const &plane = frustum.getPlanes()[i];
+            margin = std::min(margin, glm::dot(vec3(plane), worldSphere.center)
+                                      + plane.w + worldSphere.radius);
+        }
+        if (std::abs(margin) < PLANE_TOLERANCE) {
+            return EITHER;
+        }
+        return frustum.intersects(worldSphere) ? VISIBLE : CULLED;
+    }
+
+    template <typename T>
+    vector<T> readBuffer(GLuint const buffer, size_t const count) {
+        vector<T> data(count);
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, count * sizeof(T),
+                           data.data());
+        return data;
+    }
+}
+
+// //////////////////////////////////////////////////////////////// Main //
+int main() {
+    if (!createContext()) {
+        std::puts("No OpenGL 4.3 context through EGL, skipped");
+        return SKIPPED;
+    }
+
+    try {
+        std::mt19937 random(216920);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> radius(0.05f, 4.0f);
+
+        mat4 const viewProjection =
+                glm::perspective(glm::radians(60.0f), 16.0f / 9.0f,
+                                 0.5f, 40.0f)
+                * glm::lookAt(vec3(0.0f), vec3(0.3f, -0.2f, -1.0f),
+                              vec3(0.0f, 1.0f, 0.0f));
+        Frustum const frustum(viewProjection);
+
+        // Instances of one command are given contiguous output ranges, as
+        // the render queue does
+        vector<mat4> worlds(INSTANCE_COUNT);
+        vector<BoundingSphere> spheres(INSTANCE_COUNT);
+        vector<GLuint> commandOf(INSTANCE_COUNT);
+        vector<GLuint> baseInstances(COMMAND_COUNT + 1, 0);
+        for (size_t i = 0; i < INSTANCE_COUNT; ++i) {
+            worlds[i] = randomWorld(random);
+            // Every 50th sphere is empty and must never be drawn
+            spheres[i] = i % 50 == 0
+                         ? BoundingSphere()
+                         : BoundingSphere(vec3(offset(random),
+                                               offset(random),
+                                               offset(random)),
+                                          radius(random));
+            commandOf[i] = static_cast<GLuint>((i * 7919) % COMMAND_COUNT);
+            ++baseInstances[commandOf[i] + 1];
+        }
+        for (size_t command = 1; command <= COMMAND_COUNT; ++command) {
+            baseInstances[command] += baseInstances[command - 1];
+        }
+
+        GpuCulling culling;
+        StreamBuffer commands(GL_DRAW_INDIRECT_BUFFER);
+
+        auto *const commandData =
+                static_cast<DrawElementsIndirectCommand *>(commands.map(
+                        COMMAND_COUNT * sizeof(DrawElementsIndirectCommand)));
+        for (size_t command = 0; command < COMMAND_COUNT; ++command) {
+            commandData[command] = {36, 0, 0, 0, baseInstances[command]};
+        }
+        commands.unmap();
+
+        CullingInstance *const instances = culling.map(INSTANCE_COUNT);
+        for (size_t i = 0; i < INSTANCE_COUNT; ++i) {
+            instances[i].world = worlds[i];
+            instances[i].sphere = vec4(spheres[i].center, spheres[i].radius);
+            instances[i].command = commandOf[i];
+        }
+        culling.unmap();
+
+        culling.cull(viewProjection, commands);
+
+        // The culled matrices stay bound where the shader wrote them
+        GLint visibleWorlds = 0;
+        glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, 2, &visibleWorlds);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        auto const culledCommands = readBuffer<DrawElementsIndirectCommand>(
+                commands.getName(), COMMAND_COUNT);
+        auto const culledWorlds = readBuffer<mat4>(
+                static_cast<GLuint>(visibleWorlds), INSTANCE_COUNT);
+
+        if (glGetError() != GL_NO_ERROR) {
+            std::puts("FAILED: OpenGL error");
+            return 1;
+        }
+
+        // Translations are random floats, so they tell instances apart
+        std::map<std::tuple<float, float, float>, size_t> instanceAt;
+        for (size_t i = 0; i < INSTANCE_COUNT; ++i) {
+            instanceAt[std::make_tuple(worlds[i][3].x, worlds[i][3].y,
+                                       worlds[i][3].z)] = i;
+        }
+
+        vector<Expected> expected(INSTANCE_COUNT);
+        vector<bool> found(INSTANCE_COUNT, false);
+        size_t visibleCount = 0,
+               undecidedCount = 0,
+               failures = 0;
+        for (size_t i = 0; i < INSTANCE_COUNT; ++i) {
+            expected[i] = cullOnCpu(frustum, spheres[i], worlds[i]);
+            visibleCount += expected[i] == VISIBLE;
+            undecidedCount += expected[i] == EITHER;
+        }
+
+        for (size_t command = 0; command < COMMAND_COUNT; ++command) {
+            GLuint const count = culledCommands[command].instanceCount;
+            GLuint const capacity = baseInstances[command + 1]
+                                    - baseInstances[command];
+            if (count > capacity) {
+                std::printf("FAILED: command %u counts %u of %u instances\n",
+                            (unsigned)command, count, capacity);
+                return 1;
+            }
+
+            for (GLuint slot = 0; slot < count; ++slot) {
+                mat4 const &world =
+                        culledWorlds[baseInstances[command] + slot];
+                auto const instance = instanceAt.find(std::make_tuple(
+                        world[3].x, world[3].y, world[3].z));
+                if (instance == instanceAt.end()
+                    || worlds[instance->second] != world
+                    || commandOf[instance->second] != command
+                    || found[instance->second]) {
+                    std::printf("FAILED: command %u, slot %u holds a "
+                                "matrix it should not\n",
+                                (unsigned)command, slot);
+                    return 1;
+                }
+                found[instance->second] = true;
+            }
+        }
+
+        for (size_t i = 0; i < INSTANCE_COUNT; ++i) {
+            if ((expected[i] == VISIBLE && !found[i])
+                || (expected[i] == CULLED && found[i])) {
+                if (failures++ < 10) {
+                    std::printf("FAILED: instance %u %s on the GPU\n",
+                                (unsigned)i, found[i] ? "kept" : "culled");
+                }
+            }
+        }
+
+        std::printf("%u instances, %u visible, %u on a plane, "
+                    "%u mismatches\n",
+                    (unsigned)INSTANCE_COUNT, (unsigned)visibleCount,
+                    (unsigned)undecidedCount, (unsigned)failures);
+        return failures == 0 ? 0 : 1;
+    } catch (std::exception const &exception) {
+        std::printf("FAILED: %s\n", exception.what());
+        return 1;
+    }
+}
+
+// ///////////////////////////////////////////////////////////////////// //
@@ -0,0 +1,265 @@
+// //////////////////////////////////////////////////////////// Includes //
+#include "mesh-simplifier.hpp"
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+// ////////////////////////////////////////////////////////////// Usings //
+using glm::vec2;
+using glm::vec3;
+
+using std::size_t;
+using std::vector;
+
+// ///////////////////////////////////////////////////////////// Helpers //
+namespace {
+    struct TestMesh {
+        char const *name;
+        vector<Vertex> vertices;
+        vector<unsigned int> indices;
+    };
+
+    Vertex vertex(vec3 const &position, vec2 const &texCoords) {
+        Vertex result;
+        result.position = position;
+        result.texCoords = texCoords;
+        return result;
+    }
+
+    TestMesh singleTriangle() {
+        TestMesh mesh{"Single triangle", {}, {0, 1, 2}};
+        mesh.vertices = {vertex(vec3(0.0f), vec2(0.0f)),
+                         vertex(vec3(1.0f, 0.0f, 0.0f), vec2(1.0f, 0.0f)),
+                         vertex(vec3(0.0f, 1.0f, 0.0f), vec2(0.0f, 1.0f))};
+        return mesh;
+    }
+
+    // Flat, open grid of side x side quads, two triangles each
+    TestMesh grid(int const side) {
+        TestMesh mesh{"Grid", {}, {}};
+        for (int y = 0; y <= side; ++y) {
+            for (int x = 0; x <= side; ++x) {
+                vec2 const position(float(x) / side, float(y) / side);
+                mesh.vertices.push_back(vertex(
+                        vec3(position.x, position.y, 0.0f), position));
+            }
+        }
+        for (int y = 0; y < side; ++y) {
+            for (int x = 0; x < side; ++x) {
+                unsigned int const corner = y * (side + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), {
+                        corner, corner + 1, corner + side + 1,
+                        corner + 1, corner + side + 2, corner + side + 1});
+            }
+        }
+        return mesh;
+    }
+
+    // Closed unit box facing outwards, with a vertex per face corner, the
+    // way importers hand meshes over, so every edge is a texture seam
+    TestMesh box() {
+        TestMesh mesh{"Box", {}, {}};
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int side = 0; side < 2; ++side) {
+                unsigned int const first =
+                        static_cast<unsigned int>(mesh.vertices.size());
+                for (int corner = 0; corner < 4; ++corner) {
+                    vec2 const texCoords(float(corner & 1), float(corner >> 1));
+                    vec3 position;
+                    position[axis] = float(side);
+                    position[(axis + 1) % 3] = texCoords.x;
+                    position[(axis + 2) % 3] = texCoords.y;
+                    mesh.vertices.push_back(vertex(position, texCoords));
+                }
+                // The corners run counter-clockwise seen from +axis
+                if (side == 1) {
+                    mesh.indices.insert(mesh.indices.end(), {
+                            first, first + 1, first + 2,
+                            first + 1, first + 3, first + 2});
+                } else {
+                    mesh.indices.insert(mesh.indices.end(), {
+                            first, first + 2, first + 1,
+                            first + 1, first + 2, first + 3});
+                }
+            }
+        }
+        return mesh;
+    }
+
+    vec3 normalOf(TestMesh const &mesh, vector<unsigned int> const &indices,
+                  size_t const i) {
+        vec3 const a = mesh.vertices[indices[i]].position,
+                   b = mesh.vertices[indices[i + 1]].position,
+                   c = mesh.vertices[indices[i + 2]].position;
+        return glm::cross(b - a, c - a);
+    }
+
+    // Whole triangles over the mesh's own vertices
+    bool isValid(TestMesh const &mesh, vector<unsigned int> const &indices) {
+        if (indices.size() % 3 != 0) {
+            return false;
+        }
+        for (unsigned int const index : indices) {
+            if (index >= mesh.vertices.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every triangle of the grid still faces +z and every edge only one
+    // triangle uses lies on a side of the unit square, so the outline is
+    // where it was
+    bool keepsGridShape(TestMesh const &mesh,
+                        vector<unsigned int> const &indices) {
+        vector<std::pair<vec2, vec2>> edges;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            if (normalOf(mesh, indices, i).z <= 0.0f) {
+                return false;
+            }
+            for (int corner = 0; corner < 3; ++corner) {
+                vec3 const a = mesh.vertices[indices[i + corner]].position,
+                           b = mesh.vertices[
+                                   indices[i + (corner + 1) % 3]].position;
+                edges.emplace_back(vec2(a.x, a.y), vec2(b.x, b.y));
+            }
+        }
+
+        for (auto const &edge : edges) {
+            // Shared edges run the other way in the neighbouring triangle
+            bool shared = false;
+            for (auto const &other : edges) {
+                shared = shared || (other.first == edge.second &&
+                                    other.second == edge.first);
+            }
+            if (shared) {
+                continue;
+            }
+
+            bool onSide = false;
+            for (int axis = 0; axis < 2; ++axis) {
+                for (float const side : {0.0f, 1.0f}) {
+                    onSide = onSide || (edge.first[axis] == side &&
+                                        edge.second[axis] == side);
+                }
+            }
+            if (!onSide) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every edge of the box runs the other way in exactly one other
+    // triangle - the surface is closed and consistently wound, which a
+    // triangle turned over would break - and the enclosed volume is never
+    // negative
+    bool keepsClosedSurface(TestMesh const &mesh,
+                            vector<unsigned int> const &indices,
+                            float &volume) {
+        vector<std::pair<vec3, vec3>> edges;
+        volume = 0.0f;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            vec3 const a = mesh.vertices[indices[i]].position;
+            volume += glm::dot(a, normalOf(mesh, indices, i)) / 6.0f;
+            for (int corner = 0; corner < 3; ++corner) {
+                edges.emplace_back(
+                        mesh.vertices[indices[i + corner]].position,
+                        mesh.vertices[indices[i + (corner + 1) % 3]].position);
+            }
+        }
+
+        for (auto const &edge : edges) {
+            int same = 0, reversed = 0;
+            for (auto const &other : edges) {
+                same += other.first == edge.first &&
+                        other.second == edge.second;
+                reversed += other.first == edge.second &&
+                            other.second == edge.first;
+            }
+            if (same != 1 || reversed != 1) {
+                return false;
+            }
+        }
+        return volume >= 0.0f;
+    }
+
+    int check(char const *name, size_t const before, size_t const target,
+              size_t const after, bool const passed) {
+        std::printf("%s: %u triangles, %u after simplification to %u%s\n",
+                    name, (unsigned)before, (unsigned)after,
+                    (unsigned)target, passed ? "" : " - FAILED");
+        return passed ? 0 : 1;
+    }
+}
+
+// //////////////////////////////////////////////////////////////// Main //
+int main() {
+    int failures = 0;
+
+    // Asking for every index must keep every triangle
+    for (TestMesh const &mesh : {singleTriangle(), grid(8), box()}) {
+        vector<unsigned int> const simplified = simplifyMesh(
+                mesh.vertices, mesh.indices, mesh.indices.size());
+
+        size_t const before = mesh.indices.size() / 3,
+                     after = simplified.size() / 3;
+        failures += check(mesh.name, before, before, after,
+                          isValid(mesh, simplified) && after == before);
+    }
+
+    // A flat grid has plenty of free collapses, along its borders too, so
+    // it must reach the target without moving its outline or turning a
+    // triangle over
+    TestMesh const flat = grid(8);
+    for (size_t const divisor : {2, 4, 8}) {
+        size_t const before = flat.indices.size() / 3,
+                     target = before / divisor;
+        vector<unsigned int> const simplified = simplifyMesh(
+                flat.vertices, flat.indices, target * 3);
+
+        size_t const after = simplified.size() / 3;
+        failures += check(flat.name, before, target, after,
+                          isValid(flat, simplified) && after > 0 &&
+                          after <= target &&
+                          keepsGridShape(flat, simplified));
+    }
+
+    // Every edge of the box is a seam and every collapse bends the
+    // surface, yet half the triangles still enclose a volume
+    TestMesh const closed = box();
+    size_t const boxTriangles = closed.indices.size() / 3;
+    {
+        size_t const target = boxTriangles / 2;
+        vector<unsigned int> const simplified = simplifyMesh(
+                closed.vertices, closed.indices, target * 3);
+
+        float volume;
+        size_t const after = simplified.size() / 3;
+        failures += check(closed.name, boxTriangles, target, after,
+                          isValid(closed, simplified) && after <= target &&
+                          keepsClosedSurface(closed, simplified, volume) &&
+                          volume > 0.0f);
+    }
+
+    // Fewer than four triangles cannot enclose a volume, so asking for
+    // three flattens the box into a double-sided sheet - but one still
+    // closed, with no triangle turned over
+    {
+        size_t const target = boxTriangles / 4;
+        vector<unsigned int> const simplified = simplifyMesh(
+                closed.vertices, closed.indices, target * 3);
+
+        float volume;
+        size_t const after = simplified.size() / 3;
+        failures += check(closed.name, boxTriangles, target, after,
+                          isValid(closed, simplified) && after > 0 &&
+                          after <= target &&
+                          keepsClosedSurface(closed, simplified, volume));
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+// ///////////////////////////////////////////////////////////////////// //